@@ -63,7 +63,7 @@ componentID_(componentID),
 mainDispatcher_(dispatcher),
 networkInterface_(ninterface),
 pTCPPacketReceiver_(NULL),
-pBlowfishFilter_(NULL),
+pEncryptionFilter_(NULL),
 threadPool_(),
 entryScript_(),
 state_(C_STATE_INIT)
@@ -84,7 +84,7 @@ state_(C_STATE_INIT)
 //-------------------------------------------------------------------------------------
 ClientApp::~ClientApp()
 {
-	SAFE_RELEASE(pBlowfishFilter_);
+	SAFE_RELEASE(pEncryptionFilter_);
 }
 
 //-------------------------------------------------------------------------------------		
@@ -375,10 +375,10 @@ void ClientApp::handleGameTick()
 					(*pBundle) << KBEVersion::versionString();
 					(*pBundle) << KBEVersion::scriptVersionString();
 
-					if(Mercury::g_channelExternalEncryptType == 1)
+					pEncryptionFilter_ = Mercury::createEncryptionFilter(Mercury::g_channelExternalEncryptType);
+					if(pEncryptionFilter_)
 					{
-						pBlowfishFilter_ = new Mercury::BlowfishFilter();
-						(*pBundle).appendBlob(pBlowfishFilter_->key());
+						(*pBundle).appendBlob(pEncryptionFilter_->key());
 						pServerChannel_->pFilter(NULL);
 					}
 					else
@@ -589,10 +589,10 @@ bool ClientApp::login(std::string accountName, std::string passwd,
 		(*pBundle) << KBEVersion::versionString();
 		(*pBundle) << KBEVersion::scriptVersionString();
 
-		if(Mercury::g_channelExternalEncryptType == 1)
+		pEncryptionFilter_ = Mercury::createEncryptionFilter(Mercury::g_channelExternalEncryptType);
+		if(pEncryptionFilter_)
 		{
-			pBlowfishFilter_ = new Mercury::BlowfishFilter();
-			(*pBundle).appendBlob(pBlowfishFilter_->key());
+			(*pBundle).appendBlob(pEncryptionFilter_->key());
 		}
 		else
 		{
@@ -611,10 +611,10 @@ bool ClientApp::login(std::string accountName, std::string passwd,
 void ClientApp::onHelloCB_(Mercury::Channel* pChannel, const std::string& verInfo, 
 		const std::string& scriptVerInfo, COMPONENT_TYPE componentType)
 {
-	if(Mercury::g_channelExternalEncryptType == 1)
+	if(pEncryptionFilter_)
 	{
-		pServerChannel_->pFilter(pBlowfishFilter_);
-		pBlowfishFilter_ = NULL;
+		pServerChannel_->pFilter(pEncryptionFilter_);
+		pEncryptionFilter_ = NULL;
 	}
 
 	if(componentType == LOGINAPP_TYPE)
@@ -227,7 +227,7 @@ protected:
 	Mercury::NetworkInterface&								networkInterface_;
 	
 	Mercury::TCPPacketReceiver*								pTCPPacketReceiver_;
-	Mercury::BlowfishFilter*								pBlowfishFilter_;
+	Mercury::EncryptionFilter*								pEncryptionFilter_;
 
 	// ̳߳
 	thread::ThreadPool										threadPool_;
@@ -26,6 +26,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "network/fixed_messages.hpp"
 #include "network/common.hpp"
 #include "network/message_handler.hpp"
+#include "network/reliable_udp_filter.hpp"
 #include "entitydef/scriptdef_module.hpp"
 #include "entitydef/entity_mailbox.hpp"
 #include "entitydef/entitydef.hpp"
@@ -452,6 +453,7 @@ Mercury::Channel* ClientObjectBase::initLoginappChannel(std::string accountName,
 	pEndpoint->addr(addr);
 
 	pServerChannel_->endpoint(pEndpoint);
+	Mercury::installReliableUDPFilter(pServerChannel_);
 	pEndpoint->setnonblocking(true);
 	pEndpoint->setnodelay(true);
 
@@ -489,6 +491,7 @@ Mercury::Channel* ClientObjectBase::initBaseappChannel()
 	pEndpoint->addr(addr);
 
 	pServerChannel_->endpoint(pEndpoint);
+	Mercury::installReliableUDPFilter(pServerChannel_);
 	pEndpoint->setnonblocking(true);
 	pEndpoint->setnodelay(true);
 
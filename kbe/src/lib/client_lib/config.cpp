@@ -213,11 +213,28 @@ bool Config::loadConfig(std::string fileName)
 			}
 		};
 
+		childnode = xml->enterNode(rootNode, "reliableUDP");
+		if(childnode)
+		{
+			TiXmlNode* childnode1 = xml->enterNode(childnode, "external");
+			if(childnode1)
+				Mercury::g_extReliableUDP = (xml->getValStr(childnode1) == "true");
+		}
+
 		childnode = xml->enterNode(rootNode, "encrypt_type");
 		if(childnode)
 		{
 			Mercury::g_channelExternalEncryptType = xml->getValInt(childnode);
 		}
+
+		// ܹ滻ͨϵĿɿUDP ߲ͬʱʹ
+		if(Mercury::g_extReliableUDP && Mercury::g_channelExternalEncryptType > 0)
+		{
+			ERROR_MSG(boost::format("Config::loadConfig: reliableUDP/external can't be used with encrypt_type(%1%), "
+				"reliableUDP is disabled!\n") % (int)Mercury::g_channelExternalEncryptType);
+
+			Mercury::g_extReliableUDP = false;
+		}
 	}
 
 	rootNode = xml->getRootNode("telnet_service");
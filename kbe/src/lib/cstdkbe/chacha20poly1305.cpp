@@ -0,0 +1,379 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2012 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "chacha20poly1305.hpp"
+#include "helper/debug_helper.hpp"
+#include "openssl/rand.h"
+
+namespace KBEngine {
+
+namespace
+{
+
+inline uint32 load32(const uint8 * p)
+{
+	return ((uint32)p[0]) | ((uint32)p[1] << 8) | ((uint32)p[2] << 16) | ((uint32)p[3] << 24);
+}
+
+inline void store32(uint8 * p, uint32 v)
+{
+	p[0] = (uint8)v;
+	p[1] = (uint8)(v >> 8);
+	p[2] = (uint8)(v >> 16);
+	p[3] = (uint8)(v >> 24);
+}
+
+inline uint32 rotl32(uint32 v, int c)
+{
+	return (v << c) | (v >> (32 - c));
+}
+
+#define CHACHA20_QUARTERROUND(a, b, c, d)											\
+	a += b; d ^= a; d = rotl32(d, 16);												\
+	c += d; b ^= c; b = rotl32(b, 12);												\
+	a += b; d ^= a; d = rotl32(d, 8);												\
+	c += d; b ^= c; b = rotl32(b, 7);
+
+/*
+	Poly1305 ʹ26λ(5limb)Ա32λƽ̨ҲֻҪ32x32->64ĳ˷
+*/
+class Poly1305
+{
+public:
+	Poly1305(const uint8 * key)
+	{
+		r_[0] = (load32(key + 0)) & 0x3ffffff;
+		r_[1] = (load32(key + 3) >> 2) & 0x3ffff03;
+		r_[2] = (load32(key + 6) >> 4) & 0x3ffc0ff;
+		r_[3] = (load32(key + 9) >> 6) & 0x3f03fff;
+		r_[4] = (load32(key + 12) >> 8) & 0x00fffff;
+
+		for(int i = 0; i < 5; ++i)
+			h_[i] = 0;
+
+		for(int i = 0; i < 4; ++i)
+			pad_[i] = load32(key + 16 + i * 4);
+	}
+
+	// ݣ 16ֽڵβ0(AEADmacݱǰ16ֽڶ)
+	void updatePadded(const uint8 * m, uint32 length)
+	{
+		while(length >= 16)
+		{
+			block(m);
+			m += 16;
+			length -= 16;
+		}
+
+		if(length > 0)
+		{
+			uint8 buf[16];
+			memset(buf, 0, sizeof(buf));
+			memcpy(buf, m, length);
+			block(buf);
+		}
+	}
+
+	void block(const uint8 * m)
+	{
+		const uint32 r0 = r_[0], r1 = r_[1], r2 = r_[2], r3 = r_[3], r4 = r_[4];
+		const uint32 s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+
+		uint32 h0 = h_[0], h1 = h_[1], h2 = h_[2], h3 = h_[3], h4 = h_[4];
+
+		h0 += (load32(m + 0)) & 0x3ffffff;
+		h1 += (load32(m + 3) >> 2) & 0x3ffffff;
+		h2 += (load32(m + 6) >> 4) & 0x3ffffff;
+		h3 += (load32(m + 9) >> 6) & 0x3ffffff;
+		h4 += (load32(m + 12) >> 8) | (1 << 24);
+
+		uint64 d0 = (uint64)h0 * r0 + (uint64)h1 * s4 + (uint64)h2 * s3 + (uint64)h3 * s2 + (uint64)h4 * s1;
+		uint64 d1 = (uint64)h0 * r1 + (uint64)h1 * r0 + (uint64)h2 * s4 + (uint64)h3 * s3 + (uint64)h4 * s2;
+		uint64 d2 = (uint64)h0 * r2 + (uint64)h1 * r1 + (uint64)h2 * r0 + (uint64)h3 * s4 + (uint64)h4 * s3;
+		uint64 d3 = (uint64)h0 * r3 + (uint64)h1 * r2 + (uint64)h2 * r1 + (uint64)h3 * r0 + (uint64)h4 * s4;
+		uint64 d4 = (uint64)h0 * r4 + (uint64)h1 * r3 + (uint64)h2 * r2 + (uint64)h3 * r1 + (uint64)h4 * r0;
+
+		uint32 c;
+		c = (uint32)(d0 >> 26); h0 = (uint32)d0 & 0x3ffffff;
+		d1 += c; c = (uint32)(d1 >> 26); h1 = (uint32)d1 & 0x3ffffff;
+		d2 += c; c = (uint32)(d2 >> 26); h2 = (uint32)d2 & 0x3ffffff;
+		d3 += c; c = (uint32)(d3 >> 26); h3 = (uint32)d3 & 0x3ffffff;
+		d4 += c; c = (uint32)(d4 >> 26); h4 = (uint32)d4 & 0x3ffffff;
+		h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+		h1 += c;
+
+		h_[0] = h0; h_[1] = h1; h_[2] = h2; h_[3] = h3; h_[4] = h4;
+	}
+
+	void finish(uint8 * tag)
+	{
+		uint32 h0 = h_[0], h1 = h_[1], h2 = h_[2], h3 = h_[3], h4 = h_[4];
+		uint32 c;
+
+		c = h1 >> 26; h1 &= 0x3ffffff;
+		h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+		h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+		h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+		h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+		h1 += c;
+
+		// h - p ֧ѡhh - p
+		uint32 g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+		uint32 g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+		uint32 g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+		uint32 g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+		uint32 g4 = h4 + c - (1 << 26);
+
+		uint32 mask = (g4 >> 31) - 1;
+		g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+		mask = ~mask;
+		h0 = (h0 & mask) | g0;
+		h1 = (h1 & mask) | g1;
+		h2 = (h2 & mask) | g2;
+		h3 = (h3 & mask) | g3;
+		h4 = (h4 & mask) | g4;
+
+		h0 = (h0) | (h1 << 26);
+		h1 = (h1 >> 6) | (h2 << 20);
+		h2 = (h2 >> 12) | (h3 << 14);
+		h3 = (h3 >> 18) | (h4 << 8);
+
+		uint64 f;
+		f = (uint64)h0 + pad_[0]; h0 = (uint32)f;
+		f = (uint64)h1 + pad_[1] + (f >> 32); h1 = (uint32)f;
+		f = (uint64)h2 + pad_[2] + (f >> 32); h2 = (uint32)f;
+		f = (uint64)h3 + pad_[3] + (f >> 32); h3 = (uint32)f;
+
+		store32(tag + 0, h0);
+		store32(tag + 4, h1);
+		store32(tag + 8, h2);
+		store32(tag + 12, h3);
+	}
+
+private:
+	uint32 r_[5];
+	uint32 h_[5];
+	uint32 pad_[4];
+};
+
+}
+
+//-------------------------------------------------------------------------------------
+KBEChaCha20Poly1305::KBEChaCha20Poly1305(const Key & key):
+key_(key),
+isGood_(false)
+{
+	initKey();
+}
+
+//-------------------------------------------------------------------------------------
+KBEChaCha20Poly1305::KBEChaCha20Poly1305():
+key_(KEY_SIZE, 0),
+isGood_(false)
+{
+	RAND_bytes((unsigned char*)const_cast<char *>(key_.c_str()),
+		key_.size());
+
+	if (this->initKey())
+	{
+		DEBUG_MSG(boost::format("KBEChaCha20Poly1305::KBEChaCha20Poly1305(): Using key: %1%\n") %
+			this->readableKey());
+	}
+}
+
+//-------------------------------------------------------------------------------------
+KBEChaCha20Poly1305::~KBEChaCha20Poly1305()
+{
+	memset(keyWords_, 0, sizeof(keyWords_));
+}
+
+//-------------------------------------------------------------------------------------
+bool KBEChaCha20Poly1305::initKey()
+{
+	if ((int)key_.size() == KEY_SIZE)
+	{
+		const uint8 * pKey = (const uint8 *)key_.data();
+		for(int i = 0; i < 8; ++i)
+			keyWords_[i] = load32(pKey + i * 4);
+
+		isGood_ = true;
+	}
+	else
+	{
+		ERROR_MSG(boost::format("KBEChaCha20Poly1305::initKey: "
+			"invalid length %1%\n") %
+			key_.size() );
+
+		memset(keyWords_, 0, sizeof(keyWords_));
+		isGood_ = false;
+	}
+
+	return isGood_;
+}
+
+//-------------------------------------------------------------------------------------
+const char * KBEChaCha20Poly1305::readableKey() const
+{
+	static char buf[1024];
+	char *c = buf;
+
+	for (int i=0; i < (int)key_.size(); i++)
+	{
+		c += sprintf(c, "%02hhX ", (unsigned char)key_[i]);
+	}
+
+	c[-1] = '\0';
+	return buf;
+}
+
+//-------------------------------------------------------------------------------------
+void KBEChaCha20Poly1305::chacha20Block(const uint8 * nonce, uint32 counter, uint32 * output) const
+{
+	uint32 state[16];
+	state[0] = 0x61707865;
+	state[1] = 0x3320646e;
+	state[2] = 0x79622d32;
+	state[3] = 0x6b206574;
+
+	for(int i = 0; i < 8; ++i)
+		state[4 + i] = keyWords_[i];
+
+	state[12] = counter;
+	state[13] = load32(nonce + 0);
+	state[14] = load32(nonce + 4);
+	state[15] = load32(nonce + 8);
+
+	uint32 x0 = state[0], x1 = state[1], x2 = state[2], x3 = state[3];
+	uint32 x4 = state[4], x5 = state[5], x6 = state[6], x7 = state[7];
+	uint32 x8 = state[8], x9 = state[9], x10 = state[10], x11 = state[11];
+	uint32 x12 = state[12], x13 = state[13], x14 = state[14], x15 = state[15];
+
+	for(int i = 0; i < 10; ++i)
+	{
+		CHACHA20_QUARTERROUND(x0, x4, x8, x12)
+		CHACHA20_QUARTERROUND(x1, x5, x9, x13)
+		CHACHA20_QUARTERROUND(x2, x6, x10, x14)
+		CHACHA20_QUARTERROUND(x3, x7, x11, x15)
+		CHACHA20_QUARTERROUND(x0, x5, x10, x15)
+		CHACHA20_QUARTERROUND(x1, x6, x11, x12)
+		CHACHA20_QUARTERROUND(x2, x7, x8, x13)
+		CHACHA20_QUARTERROUND(x3, x4, x9, x14)
+	}
+
+	output[0] = x0 + state[0]; output[1] = x1 + state[1];
+	output[2] = x2 + state[2]; output[3] = x3 + state[3];
+	output[4] = x4 + state[4]; output[5] = x5 + state[5];
+	output[6] = x6 + state[6]; output[7] = x7 + state[7];
+	output[8] = x8 + state[8]; output[9] = x9 + state[9];
+	output[10] = x10 + state[10]; output[11] = x11 + state[11];
+	output[12] = x12 + state[12]; output[13] = x13 + state[13];
+	output[14] = x14 + state[14]; output[15] = x15 + state[15];
+}
+
+//-------------------------------------------------------------------------------------
+void KBEChaCha20Poly1305::chacha20Xor(const uint8 * nonce, uint32 counter,
+	const uint8 * src, uint8 * dest, uint32 length) const
+{
+	uint32 keyStream[16];
+
+	// 鰴32λ βֽ
+	while(length >= 64)
+	{
+		chacha20Block(nonce, counter++, keyStream);
+
+		for(int i = 0; i < 16; ++i)
+			store32(dest + i * 4, load32(src + i * 4) ^ keyStream[i]);
+
+		src += 64;
+		dest += 64;
+		length -= 64;
+	}
+
+	if(length > 0)
+	{
+		chacha20Block(nonce, counter, keyStream);
+
+		uint8 buf[64];
+		for(int i = 0; i < 16; ++i)
+			store32(buf + i * 4, keyStream[i]);
+
+		for(uint32 i = 0; i < length; ++i)
+			dest[i] = src[i] ^ buf[i];
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void KBEChaCha20Poly1305::poly1305Tag(const uint8 * nonce, const uint8 * aad, uint32 aadLength,
+	const uint8 * cipher, uint32 length, uint8 * tag) const
+{
+	// һԿΪ0Կǰ32ֽ
+	uint32 block0[16];
+	chacha20Block(nonce, 0, block0);
+
+	uint8 otk[32];
+	for(int i = 0; i < 8; ++i)
+		store32(otk + i * 4, block0[i]);
+
+	Poly1305 poly(otk);
+	poly.updatePadded(aad, aadLength);
+	poly.updatePadded(cipher, length);
+
+	uint8 lengths[16];
+	store32(lengths + 0, aadLength);
+	store32(lengths + 4, 0);
+	store32(lengths + 8, length);
+	store32(lengths + 12, 0);
+	poly.block(lengths);
+
+	poly.finish(tag);
+	memset(otk, 0, sizeof(otk));
+}
+
+//-------------------------------------------------------------------------------------
+void KBEChaCha20Poly1305::seal(const uint8 * nonce, const uint8 * aad, uint32 aadLength,
+	const uint8 * src, uint8 * dest, uint32 length, uint8 * tag)
+{
+	chacha20Xor(nonce, 1, src, dest, length);
+	poly1305Tag(nonce, aad, aadLength, dest, length, tag);
+}
+
+//-------------------------------------------------------------------------------------
+bool KBEChaCha20Poly1305::open(const uint8 * nonce, const uint8 * aad, uint32 aadLength,
+	const uint8 * src, uint8 * dest, uint32 length, const uint8 * tag)
+{
+	uint8 expected[TAG_SIZE];
+	poly1305Tag(nonce, aad, aadLength, src, length, expected);
+
+	// Ƚϣ й¶ڼֽڲͬ
+	uint8 diff = 0;
+	for(int i = 0; i < TAG_SIZE; ++i)
+		diff |= expected[i] ^ tag[i];
+
+	if(diff != 0)
+		return false;
+
+	chacha20Xor(nonce, 1, src, dest, length);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,80 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2012 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef KBENGINE_CHACHA20POLY1305_HPP
+#define KBENGINE_CHACHA20POLY1305_HPP
+
+#include "cstdkbe/platform.hpp"
+#include <string>
+
+namespace KBEngine {
+
+/*
+	ChaCha20-Poly1305 AEAD(RFC 7539)
+	openssl汾ṩAEAD㷨 һݲضָʵ֣
+	벻Ҫ䣬 ֤һαɡ
+*/
+class KBEChaCha20Poly1305
+{
+public:
+	static const int KEY_SIZE = 256 / 8;
+	static const int NONCE_SIZE = 96 / 8;
+	static const int TAG_SIZE = 128 / 8;
+
+	typedef std::string Key;
+
+	virtual ~KBEChaCha20Poly1305();
+	KBEChaCha20Poly1305(const Key & key);
+	KBEChaCha20Poly1305();
+
+	const Key & key() const { return key_; }
+	const char * readableKey() const;
+	bool isGood() const { return isGood_; }
+
+	/**
+		srcдdest(srcͬ) ֤aadģ tagдTAG_SIZEֽ
+	*/
+	void seal(const uint8 * nonce, const uint8 * aad, uint32 aadLength,
+		const uint8 * src, uint8 * dest, uint32 length, uint8 * tag);
+
+	/**
+		Уtag ͨŽsrcdest(srcͬ)
+	*/
+	bool open(const uint8 * nonce, const uint8 * aad, uint32 aadLength,
+		const uint8 * src, uint8 * dest, uint32 length, const uint8 * tag);
+
+protected:
+	bool initKey();
+
+	void chacha20Block(const uint8 * nonce, uint32 counter, uint32 * output) const;
+	void chacha20Xor(const uint8 * nonce, uint32 counter, const uint8 * src, uint8 * dest, uint32 length) const;
+	void poly1305Tag(const uint8 * nonce, const uint8 * aad, uint32 aadLength,
+		const uint8 * cipher, uint32 length, uint8 * tag) const;
+
+	Key key_;
+	bool isGood_;
+
+	uint32 keyWords_[8];
+};
+
+}
+
+#endif // KBENGINE_CHACHA20POLY1305_HPP
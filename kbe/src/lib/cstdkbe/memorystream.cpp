@@ -19,6 +19,12 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "memorystream.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KBE_PACK_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace KBEngine
 {
 static ObjectPool<MemoryStream> _g_objPool("MemoryStream");
@@ -46,10 +52,135 @@ MemoryStream::SmartPoolObjectPtr MemoryStream::createSmartPoolObj()
 //-------------------------------------------------------------------------------------
 size_t MemoryStream::getPoolObjectBytes()
 {
-	size_t bytes = sizeof(rpos_) + sizeof(wpos_) + data_.size();
+	size_t bytes = sizeof(rpos_) + sizeof(wpos_) + data_.capacity();
 	return bytes;
 }
 
+//-------------------------------------------------------------------------------------
+#ifdef KBE_PACK_USE_SSE2
+/**
+	MemoryStream::packXZͬı룬 һδ4
+*/
+static inline __m128i packXZ_SSE2(__m128 x, __m128 z)
+{
+	const __m128i signMask = _mm_set1_epi32(0x80000000);
+	const __m128i allOnes = _mm_set1_epi32(-1);
+	const __m128 two = _mm_set1_ps(2.f);
+
+	// շż2.f-2.f
+	x = _mm_add_ps(x, _mm_or_ps(two, _mm_and_ps(x, _mm_castsi128_ps(signMask))));
+	z = _mm_add_ps(z, _mm_or_ps(two, _mm_and_ps(z, _mm_castsi128_ps(signMask))));
+
+	__m128i ux = _mm_castps_si128(x);
+	__m128i uz = _mm_castps_si128(z);
+
+	const __m128i expMask = _mm_set1_epi32(0x7c000000);
+	const __m128i expValue = _mm_set1_epi32(0x40000000);
+	const __m128i mantMask = _mm_set1_epi32(0x3ffc000);
+
+	// Ϊ
+	__m128i xCeiling = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(ux, expMask), expValue), allOnes), 
+		_mm_cmpeq_epi32(_mm_and_si128(ux, mantMask), mantMask));
+
+	__m128i zCeiling = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(uz, expMask), expValue), allOnes), 
+		_mm_cmpeq_epi32(_mm_and_si128(uz, mantMask), mantMask));
+
+	const __m128i xBits = _mm_set1_epi32(0x7ff000);
+	const __m128i zBits = _mm_set1_epi32(0x0007ff);
+	const __m128i roundBit = _mm_set1_epi32(0x4000);
+
+	__m128i data = _mm_or_si128(_mm_and_si128(xCeiling, xBits), _mm_and_si128(zCeiling, zBits));
+
+	// 8λβ3λָ
+	data = _mm_or_si128(data, _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(ux, 3), xBits), 
+		_mm_srli_epi32(_mm_and_si128(ux, roundBit), 2)));
+
+	data = _mm_or_si128(data, _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(uz, 15), zBits), 
+		_mm_srli_epi32(_mm_and_si128(uz, roundBit), 14)));
+
+	data = _mm_and_si128(data, _mm_set1_epi32(0x7ff7ff));
+
+	// Ʊλ
+	data = _mm_or_si128(data, _mm_and_si128(_mm_srli_epi32(ux, 8), _mm_set1_epi32(0x800000)));
+	data = _mm_or_si128(data, _mm_and_si128(_mm_srli_epi32(uz, 20), _mm_set1_epi32(0x000800)));
+	return data;
+}
+
+//-------------------------------------------------------------------------------------
+/**
+	MemoryStream::packYͬı룬 һδ4
+*/
+static inline __m128i packY_SSE2(__m128 y)
+{
+	const __m128i signMask = _mm_set1_epi32(0x80000000);
+	y = _mm_add_ps(y, _mm_or_ps(_mm_set1_ps(2.f), _mm_and_ps(y, _mm_castsi128_ps(signMask))));
+
+	__m128i uy = _mm_castps_si128(y);
+	return _mm_or_si128(_mm_and_si128(_mm_srli_epi32(uy, 12), _mm_set1_epi32(0x7fff)), 
+		_mm_and_si128(_mm_srli_epi32(uy, 16), _mm_set1_epi32(0x8000)));
+}
+#endif
+
+//-------------------------------------------------------------------------------------
+static inline void writePackedXZ(uint8* out, uint32 data)
+{
+	out[0] = (uint8)(data >> 16);
+	out[1] = (uint8)(data >> 8);
+	out[2] = (uint8)data;
+}
+
+//-------------------------------------------------------------------------------------
+static inline void writePackedY(uint8* out, uint16 data)
+{
+	// MemoryStream << uint16ֽһ
+	EndianConvert(data);
+	memcpy(out, &data, sizeof(uint16));
+}
+
+//-------------------------------------------------------------------------------------
+void MemoryStream::packRelativePositions(const float* xs, const float* ys, const float* zs, uint32 count, 
+	float ox, float oy, float oz, uint8* outXZ, uint8* outY)
+{
+	bool withY = ys != NULL && outY != NULL;
+	uint32 i = 0;
+
+#ifdef KBE_PACK_USE_SSE2
+	const __m128 vox = _mm_set1_ps(ox);
+	const __m128 voy = _mm_set1_ps(oy);
+	const __m128 voz = _mm_set1_ps(oz);
+
+	uint32 datas[4];
+
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_sub_ps(_mm_loadu_ps(xs + i), vox);
+		__m128 z = _mm_sub_ps(_mm_loadu_ps(zs + i), voz);
+
+		_mm_storeu_si128((__m128i*)datas, packXZ_SSE2(x, z));
+		
+		for(uint32 n = 0; n < 4; ++n)
+			writePackedXZ(outXZ + (i + n) * 3, datas[n]);
+
+		if(withY)
+		{
+			__m128 y = _mm_sub_ps(_mm_loadu_ps(ys + i), voy);
+			_mm_storeu_si128((__m128i*)datas, packY_SSE2(y));
+
+			for(uint32 n = 0; n < 4; ++n)
+				writePackedY(outY + (i + n) * 2, (uint16)datas[n]);
+		}
+	}
+#endif
+
+	for(; i < count; ++i)
+	{
+		writePackedXZ(outXZ + i * 3, packXZ(xs[i] - ox, zs[i] - oz));
+
+		if(withY)
+			writePackedY(outY + i * 2, packY(ys[i] - oy));
+	}
+}
+
 //-------------------------------------------------------------------------------------
 } 
 
@@ -102,6 +102,10 @@ public:
 	virtual size_t getPoolObjectBytes();
 
     const static size_t DEFAULT_SIZE = 0x1000;
+
+	// յʱౣĻС ͷŵ еڳдڴ
+	const static size_t POOL_RETAIN_SIZE = 0x10000;
+
     MemoryStream(): rpos_(0), wpos_(0)
     {
         data_.reserve(DEFAULT_SIZE);
@@ -124,6 +128,30 @@ public:
 	void onReclaimObject()
 	{
 		clear(false);
+
+		if(data_.capacity() > POOL_RETAIN_SIZE)
+		{
+			std::vector<uint8>().swap(data_);
+			data_.reserve(DEFAULT_SIZE);
+		}
+	}
+
+	/**
+		尴256B/4KB/64KB/1MBּݣ 1MB1MB
+		дСȷɶ·뿽
+	*/
+	static size_t sizeClass(size_t size)
+	{
+		if(size <= 0x100)
+			return 0x100;
+
+		if(size <= 0x1000)
+			return 0x1000;
+
+		if(size <= 0x10000)
+			return 0x10000;
+
+		return (size + 0xfffff) & ~((size_t)0xfffff);
 	}
 
     void clear(bool clearData)
@@ -586,7 +614,7 @@ public:
         assert(size() < 10000000);
 
         if (data_.size() < wpos_ + cnt)
-            data_.resize(wpos_ + cnt);
+            grow_(wpos_ + cnt);
         memcpy(&data_[wpos_], src, cnt);
         wpos_ += cnt;
     }
@@ -636,8 +664,11 @@ public:
         *this << packed;
     }
 
-    void appendPackXZ(float x, float z)
-    {
+	/**
+		x, zΪ24λݣ appendPackXZpackRelativePositionsʹ
+	*/
+	static uint32 packXZ(float x, float z)
+	{
 		PackFloatXType xPackData; 
 		xPackData.fv = x;
 
@@ -684,6 +715,36 @@ public:
 		data |=  (xPackData.uv >>  8) & 0x800000;
 		data |=  (zPackData.uv >> 20) & 0x000800;
 
+		return data;
+	}
+
+	/**
+		yΪ16λݣ appendPackYpackRelativePositionsʹ
+	*/
+	static uint16 packY(float y)
+	{
+		PackFloatXType yPackData; 
+		yPackData.fv = y;
+
+		yPackData.fv += yPackData.iv < 0 ? -2.f : 2.f;
+		uint16 data = (yPackData.uv >> 12) & 0x7fff;
+ 		data |= ((yPackData.uv >> 16) & 0x8000);
+
+		return data;
+	}
+
+	/**
+		countʵԹ۲(ox, oy, oz)λò룬 appendPackXZ/appendPackYдֽȫһ
+		xs, ys, zsΪʵ(ṹ) outXZҪcount * 3ֽڣ outYҪcount * 2ֽڣ ysoutYΪNULL򲻼y
+		֧SSE2ʱÿδ4ʵ
+	*/
+	static void packRelativePositions(const float* xs, const float* ys, const float* zs, uint32 count, 
+		float ox, float oy, float oz, uint8* outXZ, uint8* outY);
+
+    void appendPackXZ(float x, float z)
+    {
+		uint32 data = packXZ(x, z);
+
 		uint8 packs[3];
 		packs[0] = (uint8)(data >> 16);
 		packs[1] = (uint8)(data >> 8);
@@ -693,21 +754,14 @@ public:
 
 	void appendPackY(float y)
 	{
-		PackFloatXType yPackData; 
-		yPackData.fv = y;
-
-		yPackData.fv += yPackData.iv < 0 ? -2.f : 2.f;
-		uint16 data = 0;
-		data = (yPackData.uv >> 12) & 0x7fff;
- 		data |= ((yPackData.uv >> 16) & 0x8000);
-
+		uint16 data = packY(y);
 		(*this) << data;
 	}
 
     void appendPackGUID(uint64 guid)
     {
         if (data_.size() < wpos_ + sizeof(guid) + 1)
-            data_.resize(wpos_ + sizeof(guid) + 1);
+            grow_(wpos_ + sizeof(guid) + 1);
 
         size_t mask_position = wpos();
         *this << uint8(0);
@@ -839,6 +893,15 @@ public:
 
 		rpos_ = trpos;
     }
+protected:
+	void grow_(size_t newsize)
+	{
+		if(data_.capacity() < newsize)
+			data_.reserve(sizeClass(newsize));
+
+		data_.resize(newsize);
+	}
+
 protected:
 	mutable size_t rpos_, wpos_;
 	std::vector<uint8> data_;
@@ -46,34 +46,61 @@ namespace KBEngine{
 #define OBJECT_POOL_INIT_SIZE	16
 #define OBJECT_POOL_INIT_MAX_SIZE	OBJECT_POOL_INIT_SIZE * 16
 
+// ߳˽л ˽л˻ʱȫֻһ
+#define OBJECT_POOL_MAGAZINE_SIZE	64
+
 template< typename T >
 class SmartPoolObject;
 
+/*
+	
+	жջʽ棬 ʱٲڵķ䣬 ȸյĶ
+	ص߳(ͨ߳)ӵһ˽л棬 ֻ˽л˻ʱżȫֻ
+	 ֱ߳Ӽȫֻ档
+*/
 template< typename T >
 class ObjectPool
 {
 public:
-	typedef std::list<T*> OBJECTS;
+	typedef std::vector<T*> OBJECTS;
 
 	ObjectPool(std::string name):
 		objects_(),
+		magazine_(),
 		max_(OBJECT_POOL_INIT_MAX_SIZE),
+		magazineMax_(OBJECT_POOL_MAGAZINE_SIZE),
 		isDestroyed_(false),
 		mutex_(),
 		name_(name),
 		totalAlloc_(0),
-		obj_count_(0)
+		obj_count_(0),
+		createCount_(0),
+		hits_(0),
+		ownerCreateCount_(0),
+		ownerHits_(0),
+		misses_(0),
+		peakAlloc_(0),
+		ownerThreadID_(currentThreadID_())
 	{
 	}
 
 	ObjectPool(std::string name, unsigned int preAssignVal, size_t max):
 		objects_(),
+		magazine_(),
 		max_((max == 0 ? 1 : max)),
+		magazineMax_((max_ < OBJECT_POOL_MAGAZINE_SIZE ? max_ : OBJECT_POOL_MAGAZINE_SIZE)),
 		isDestroyed_(false),
 		mutex_(),
 		name_(name),
 		totalAlloc_(0),
-		obj_count_(0)
+		obj_count_(0),
+		createCount_(0),
+		hits_(0),
+		ownerCreateCount_(0),
+		ownerHits_(0),
+		misses_(0),
+		peakAlloc_(0),
+		ownerThreadID_(currentThreadID_())
 	{
 	}
 
@@ -86,20 +113,15 @@ public:
 	{
 		mutex_.lockMutex();
 		isDestroyed_ = true;
-		typename OBJECTS::iterator iter = objects_.begin();
-		for(; iter!=objects_.end(); iter++)
-		{
-			if(!(*iter)->destructorPoolObject())
-			{
-				delete (*iter);
-			}
-		}
-				
-		objects_.clear();	
+		destroyObjects_(objects_);
+		destroyObjects_(magazine_);
 		obj_count_ = 0;
 		mutex_.unlockMutex();
 	}
 
+	/**
+		ȫֻеĶ ߳˽леĶ
+	*/
 	const OBJECTS& objects(void)const { return objects_; }
 
 	void assignObjs(unsigned int preAssignVal = OBJECT_POOL_INIT_SIZE)
@@ -109,6 +131,9 @@ public:
 			++totalAlloc_;
 			++obj_count_;
 		}
+
+		if(totalAlloc_ > peakAlloc_)
+			peakAlloc_ = totalAlloc_;
 	}
 
 	/** 
@@ -118,25 +143,8 @@ public:
 	template<typename T1>
 	T* createObject(void)
 	{
-		mutex_.lockMutex();
-
-		while(true)
-		{
-			if(obj_count_ > 0)
-			{
-				T* t = static_cast<T1*>(*objects_.begin());
-				objects_.pop_front();
-				--obj_count_;
-				mutex_.unlockMutex();
-				return t;
-			}
-
-			assignObjs();
-		}
-
-		mutex_.unlockMutex();
-
-		return NULL;
+		T* t = static_cast<T1*>(popObject_());
+		return t;
 	}
 
 	/** 
@@ -145,29 +153,11 @@ public:
 	*/
 	T* createObject(void)
 	{
-		mutex_.lockMutex();
-
-		while(true)
-		{
-			if(obj_count_ > 0)
-			{
-				T* t = static_cast<T*>(*objects_.begin());
-				objects_.pop_front();
-				--obj_count_;
-
-				// ״̬
-				t->onReclaimObject();
-
-				mutex_.unlockMutex();
-				return t;
-			}
-
-			assignObjs();
-		}
-
-		mutex_.unlockMutex();
+		T* t = popObject_();
 
-		return NULL;
+		// ״̬
+		t->onReclaimObject();
+		return t;
 	}
 
 	/**
@@ -175,6 +165,15 @@ public:
 	*/
 	void reclaimObject(T* obj)
 	{
+		if(obj == NULL)
+			return;
+
+		if(isOwnerThread_() && !isDestroyed_)
+		{
+			pushMagazine_(obj);
+			return;
+		}
+
 		mutex_.lockMutex();
 		reclaimObject_(obj);
 		mutex_.unlockMutex();
@@ -185,16 +184,8 @@ public:
 	*/
 	void reclaimObject(std::list<T*>& objs)
 	{
-		mutex_.lockMutex();
-		
-		typename std::list< T* >::iterator iter = objs.begin();
-		for(; iter != objs.end(); iter++)
-		{
-			reclaimObject_((*iter));
-		}
-		
+		reclaimObjects_(objs.begin(), objs.end());
 		objs.clear();
-		mutex_.unlockMutex();
 	}
 
 	/**
@@ -202,16 +193,8 @@ public:
 	*/
 	void reclaimObject(std::vector< T* >& objs)
 	{
-		mutex_.lockMutex();
-		
-		typename std::vector< T* >::iterator iter = objs.begin();
-		for(; iter != objs.end(); iter++)
-		{
-			reclaimObject_((*iter));
-		}
-		
+		reclaimObjects_(objs.begin(), objs.end());
 		objs.clear();
-		mutex_.unlockMutex();
 	}
 
 	/**
@@ -219,6 +202,20 @@ public:
 	*/
 	void reclaimObject(std::queue<T*>& objs)
 	{
+		if(isOwnerThread_() && !isDestroyed_)
+		{
+			while(!objs.empty())
+			{
+				T* t = objs.front();
+				objs.pop();
+
+				if(t != NULL)
+					pushMagazine_(t);
+			}
+
+			return;
+		}
+
 		mutex_.lockMutex();
 		
 		while(!objs.empty())
@@ -231,7 +228,7 @@ public:
 		mutex_.unlockMutex();
 	}
 
-	size_t size(void)const{ return obj_count_; }
+	size_t size(void)const{ return obj_count_ + magazine_.size(); }
 	
 	std::string c_str()
 	{
@@ -239,7 +236,7 @@ public:
 
 		char buf[1024];
 		sprintf(buf, "ObjectPool::c_str(): name=%s, objs=%d/%d, isDestroyed=%s.\n", 
-			name_.c_str(), (int)obj_count_, (int)max_, (isDestroyed ? "true" : "false"));
+			name_.c_str(), (int)size(), (int)max_, (isDestroyed_ ? "true" : "false"));
 
 		mutex_.unlockMutex();
 		return buf;
@@ -248,9 +245,157 @@ public:
 	size_t max()const{ return max_; }
 	size_t totalAlloc()const{ return totalAlloc_; }
 
+	/**
+		ۼƴӳȡĴ ͳĳ߼еķ
+		̷ֱ߳߳(̵߳ļ) ȡʱ
+	*/
+	size_t createCount()const{ return createCount_ + ownerCreateCount_; }
+
+	/**
+		ȡʱδ(Ҫ·)Ĵ
+	*/
+	size_t hits()const{ return hits_ + ownerHits_; }
+	size_t misses()const{ return misses_; }
+
+	/**
+		طĶ(ʹе뻺е)ķֵ ռڴķֵ
+	*/
+	size_t peakAlloc()const{ return peakAlloc_; }
+
+	/**
+		жռõڴ
+		˽л̷ֻ߳ʣ Ӧ߳е(watcher߳вѯ)
+	*/
+	size_t bytes()
+	{
+		mutex_.lockMutex();
+		size_t bytes = objectsBytes_(objects_) + objectsBytes_(magazine_);
+		mutex_.unlockMutex();
+		return bytes;
+	}
+
 	bool isDestroyed()const{ return isDestroyed_; }
 
 protected:
+	/**
+		ȡһ ߳ȴ˽лȡ
+	*/
+	T* popObject_()
+	{
+		if(isOwnerThread_())
+		{
+			if(magazine_.empty())
+				refillMagazine_();
+			else
+				++ownerHits_;
+
+			T* t = magazine_.back();
+			magazine_.pop_back();
+			++ownerCreateCount_;
+			return t;
+		}
+
+		mutex_.lockMutex();
+
+		if(obj_count_ > 0)
+		{
+			++hits_;
+		}
+		else
+		{
+			++misses_;
+			assignObjs();
+		}
+
+		T* t = objects_.back();
+		objects_.pop_back();
+		--obj_count_;
+		++createCount_;
+
+		mutex_.unlockMutex();
+		return t;
+	}
+
+	/**
+		˽лˣ ȫֻȡһ ȫֻҲ·һ
+	*/
+	void refillMagazine_()
+	{
+		mutex_.lockMutex();
+
+		if(obj_count_ > 0)
+		{
+			++hits_;
+		}
+		else
+		{
+			++misses_;
+			assignObjs();
+		}
+
+		size_t n = magazineMax_ / 2;
+		if(n == 0)
+			n = 1;
+
+		while(n-- > 0 && obj_count_ > 0)
+		{
+			magazine_.push_back(objects_.back());
+			objects_.pop_back();
+			--obj_count_;
+		}
+
+		mutex_.unlockMutex();
+	}
+
+	/**
+		̻߳һ˽л棬 ˽лһ뽻ȫֻ
+	*/
+	void pushMagazine_(T* obj)
+	{
+		if(magazine_.size() >= magazineMax_)
+		{
+			size_t n = magazineMax_ / 2;
+			if(n == 0)
+				n = 1;
+
+			mutex_.lockMutex();
+
+			while(n-- > 0 && !magazine_.empty())
+			{
+				reclaimObject_(magazine_.back());
+				magazine_.pop_back();
+			}
+
+			mutex_.unlockMutex();
+		}
+
+		magazine_.push_back(obj);
+	}
+
+	template<typename ITERATOR>
+	void reclaimObjects_(ITERATOR first, ITERATOR last)
+	{
+		if(isOwnerThread_() && !isDestroyed_)
+		{
+			for(; first != last; ++first)
+			{
+				if((*first) != NULL)
+					pushMagazine_((*first));
+			}
+
+			return;
+		}
+
+		mutex_.lockMutex();
+
+		for(; first != last; ++first)
+		{
+			reclaimObject_((*first));
+		}
+
+		mutex_.unlockMutex();
+	}
+
 	/**
 		һ
 	*/
@@ -258,7 +403,7 @@ protected:
 	{
 		if(obj != NULL)
 		{
-			if(size() >= max_ || isDestroyed_)
+			if(obj_count_ >= max_ || isDestroyed_)
 			{
 				delete obj;
 				--totalAlloc_;
@@ -271,11 +416,68 @@ protected:
 		}
 	}
 
+	static void destroyObjects_(OBJECTS& objs)
+	{
+		typename OBJECTS::iterator iter = objs.begin();
+		for(; iter!=objs.end(); iter++)
+		{
+			if(!(*iter)->destructorPoolObject())
+			{
+				delete (*iter);
+			}
+		}
+				
+		objs.clear();
+	}
+
+	static size_t objectsBytes_(const OBJECTS& objs)
+	{
+		size_t bytes = 0;
+
+		typename OBJECTS::const_iterator iter = objs.begin();
+		for(; iter != objs.end(); iter++)
+		{
+			bytes += (*iter)->getPoolObjectBytes();
+		}
+
+		return bytes;
+	}
+
+#if KBE_PLATFORM == PLATFORM_WIN32
+	typedef DWORD POOL_THREAD_ID;
+
+	static POOL_THREAD_ID currentThreadID_()
+	{
+		return GetCurrentThreadId();
+	}
+
+	bool isOwnerThread_()const
+	{
+		return ownerThreadID_ == GetCurrentThreadId();
+	}
+#else
+	typedef pthread_t POOL_THREAD_ID;
+
+	static POOL_THREAD_ID currentThreadID_()
+	{
+		return pthread_self();
+	}
+
+	bool isOwnerThread_()const
+	{
+		return pthread_equal(ownerThreadID_, pthread_self()) != 0;
+	}
+#endif
+
 protected:
-	OBJECTS objects_;							// 󻺳
+	OBJECTS objects_;							// 󻺳 mutex_
+
+	OBJECTS magazine_;							// ̵߳˽л棬 
 
 	size_t max_;
 
+	size_t magazineMax_;
+
 	bool isDestroyed_;
 
 	KBEngine::thread::ThreadMutex mutex_;
@@ -285,6 +487,21 @@ protected:
 	size_t totalAlloc_;
 
 	size_t obj_count_;
+
+	// ̵߳ļmutex_ ̵߳ļֻ߳޸
+	size_t createCount_;
+
+	size_t hits_;
+
+	size_t ownerCreateCount_;
+
+	size_t ownerHits_;
+
+	size_t misses_;
+
+	size_t peakAlloc_;
+
+	POOL_THREAD_ID ownerThreadID_;				// ص߳
 };
 
 /*
@@ -26,6 +26,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "cstdkbe/cstdkbe.hpp"
 #include "cstdkbe/memorystream.hpp"
 #include "helper/debug_helper.hpp"
+#include "mysql/mysql.h"
 
 namespace KBEngine{ 
 
@@ -53,7 +54,27 @@ struct DB_OP_TABLE_ITEM_DATA
 {
 	char sqlval[MAX_BUF];
 	const char* sqlkey;
-	std::string extraDatas;
+
+	// дʱ󶨵ԤĲ ֵbindVal ַƴbindData
+	// ȡʱbindTypebindUnsignedҲԺȡ
+	enum_field_types bindType;
+	bool bindUnsigned;
+
+	union
+	{
+		int8 i8;
+		int16 i16;
+		int32 i32;
+		int64 i64;
+		uint8 u8;
+		uint16 u16;
+		uint32 u32;
+		uint64 u64;
+		float f;
+		double d;
+	}bindVal;
+
+	std::string bindData;
 };
 
 struct DB_OP_TABLE_ITEM_DATA_BOX
@@ -149,7 +149,10 @@ hasLostConnection_(false),
 inTransaction_(false),
 lock_(NULL, false),
 characterSet_(characterSet),
-collation_(collation)
+collation_(collation),
+stmts_(),
+dynamicStmts_(),
+entityStmtsPrepared_(false)
 {
 	lock_.pdbi(this);
 }
@@ -298,6 +301,8 @@ bool DBInterfaceMysql::reattach()
 //-------------------------------------------------------------------------------------
 bool DBInterfaceMysql::detach()
 {
+	clearStmts();
+
 	if(mysql())
 	{
 		::mysql_close(mysql());
@@ -397,6 +402,268 @@ bool DBInterfaceMysql::query(const char* strCommand, uint32 size, bool showexeci
     return true;
 }
 
+//-------------------------------------------------------------------------------------
+MYSQL_STMT* DBInterfaceMysql::prepareStmt(const std::string& sql, bool persistent)
+{
+	STMT_MAP::iterator iter = stmts_.find(sql);
+	if(iter != stmts_.end())
+		return iter->second;
+
+	iter = dynamicStmts_.find(sql);
+	if(iter != dynamicStmts_.end())
+		return iter->second;
+
+	// ддܶ಻ͬ䣬 ʱ̭һ entityĹ̶䲻Ӱ
+	if(!persistent && dynamicStmts_.size() >= MAX_CACHED_STMTS)
+	{
+		iter = dynamicStmts_.begin();
+		mysql_stmt_close(iter->second);
+		dynamicStmts_.erase(iter);
+	}
+
+	MYSQL_STMT* pStmt = mysql_stmt_init(pMysql_);
+	if(pStmt == NULL)
+	{
+		ERROR_MSG("DBInterfaceMysql::prepareStmt: mysql_stmt_init is error!\n");
+		return NULL;
+	}
+
+	if(mysql_stmt_prepare(pStmt, sql.c_str(), sql.size()) != 0)
+	{
+		ERROR_MSG(boost::format("DBInterfaceMysql::prepareStmt: is error(%1%:%2%)!\nsql:(%3%)\n") % 
+			mysql_stmt_errno(pStmt) % mysql_stmt_error(pStmt) % sql);
+
+		mysql_stmt_close(pStmt);
+		return NULL;
+	}
+
+	if(persistent)
+		stmts_[sql] = pStmt;
+	else
+		dynamicStmts_[sql] = pStmt;
+
+	return pStmt;
+}
+
+//-------------------------------------------------------------------------------------
+void DBInterfaceMysql::prepareEntityStmts()
+{
+	entityStmtsPrepared_ = true;
+
+	if(EntityTables::getSingletonPtr() == NULL)
+		return;
+
+	const EntityTables::TABLES_MAP& tables = EntityTables::getSingleton().tables();
+	EntityTables::TABLES_MAP::const_iterator iter = tables.begin();
+	for(; iter != tables.end(); iter++)
+	{
+		static_cast<EntityTableMysql*>(iter->second.get())->prepareStmts(this);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+MYSQL_STMT* DBInterfaceMysql::executeStmt(const std::string& sql, MYSQL_BIND* pParams, uint32 nparams)
+{
+	if(pMysql_ == NULL)
+	{
+		ERROR_MSG(boost::format("DBInterfaceMysql::executeStmt: has no attach(db).sql:(%1%)\n") % sql);
+		return NULL;
+	}
+
+	querystatistics(sql.c_str(), sql.size());
+
+	lastquery_ = sql;
+
+	if(_g_debug)
+	{
+		DEBUG_MSG(boost::format("DBInterfaceMysql::executeStmt(%1%): %2%\n") % this % lastquery_);
+	}
+
+	if(!entityStmtsPrepared_)
+		prepareEntityStmts();
+
+	MYSQL_STMT* pStmt = prepareStmt(sql);
+	if(pStmt == NULL)
+	{
+		this->throwError();
+		return NULL;
+	}
+
+	KBE_ASSERT(mysql_stmt_param_count(pStmt) == nparams);
+
+	if((nparams > 0 && mysql_stmt_bind_param(pStmt, pParams) != 0) || 
+		mysql_stmt_execute(pStmt) != 0)
+	{
+		ERROR_MSG(boost::format("DBInterfaceMysql::executeStmt: is error(%1%:%2%)!\nsql:(%3%)\n") % 
+			mysql_stmt_errno(pStmt) % mysql_stmt_error(pStmt) % lastquery_); 
+
+		// ѾʧЧ(ӶϿṹ޸) ´prepare
+		if(stmts_.erase(sql) == 0)
+			dynamicStmts_.erase(sql);
+
+		mysql_stmt_close(pStmt);
+
+		this->throwError();
+		return NULL;
+	}
+
+	return pStmt;
+}
+
+//-------------------------------------------------------------------------------------
+static unsigned long stmtFixedLength(enum_field_types type)
+{
+	switch(type)
+	{
+	case MYSQL_TYPE_TINY:
+		return sizeof(int8);
+	case MYSQL_TYPE_SHORT:
+		return sizeof(int16);
+	case MYSQL_TYPE_LONG:
+		return sizeof(int32);
+	case MYSQL_TYPE_LONGLONG:
+		return sizeof(int64);
+	case MYSQL_TYPE_FLOAT:
+		return sizeof(float);
+	case MYSQL_TYPE_DOUBLE:
+		return sizeof(double);
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------
+bool DBInterfaceMysql::fetchStmtResults(MYSQL_STMT* pStmt, const std::vector<MYSQL_BIND>& resultBinds, 
+										std::vector<std::string>& results, uint32& nfields)
+{
+	nfields = mysql_stmt_field_count(pStmt);
+	if(nfields == 0)
+		return true;
+
+	KBE_ASSERT(resultBinds.size() == nfields);
+
+	if(mysql_stmt_store_result(pStmt) != 0)
+	{
+		ERROR_MSG(boost::format("DBInterfaceMysql::fetchStmtResults: is error(%1%:%2%)!\nsql:(%3%)\n") % 
+			mysql_stmt_errno(pStmt) % mysql_stmt_error(pStmt) % lastquery_); 
+
+		return false;
+	}
+
+	// ֵаԭȡ ɷֱӸֵ پıת
+	std::vector<MYSQL_BIND> binds(resultBinds);
+	std::vector<unsigned long> fixedLengths(nfields);
+	std::vector<std::string> buffers(nfields);
+	std::vector<unsigned long> lengths(nfields);
+	std::vector<my_bool> nulls(nfields);
+
+	for(uint32 i = 0; i < nfields; i++)
+	{
+		fixedLengths[i] = stmtFixedLength(binds[i].buffer_type);
+
+		if(fixedLengths[i] == 0)
+		{
+			binds[i].buffer_type = binds[i].buffer_type == MYSQL_TYPE_BLOB ? MYSQL_TYPE_BLOB : MYSQL_TYPE_STRING;
+			buffers[i].resize(MAX_BUF);
+		}
+		else
+		{
+			buffers[i].resize(fixedLengths[i]);
+		}
+
+		binds[i].buffer = &buffers[i][0];
+		binds[i].buffer_length = buffers[i].size();
+		binds[i].length = &lengths[i];
+		binds[i].is_null = &nulls[i];
+	}
+
+	bool ret = mysql_stmt_bind_result(pStmt, &binds[0]) == 0;
+
+	while(ret)
+	{
+		int fetchret = mysql_stmt_fetch(pStmt);
+		if(fetchret == MYSQL_NO_DATA)
+			break;
+
+		if(fetchret == 1)
+		{
+			ret = false;
+			break;
+		}
+
+		for(uint32 i = 0; i < nfields; i++)
+		{
+			// ֵΪʱմ ȡʱ0
+			if(nulls[i])
+			{
+				results.push_back("");
+				continue;
+			}
+
+			if(fixedLengths[i] > 0)
+			{
+				results.push_back(buffers[i]);
+				continue;
+			}
+
+			// ʱݱضϣ õĻȡ
+			// Ѿ󶨵stmtĻܸĶ һmysql_stmt_fetchдͷŵڴ
+			if(lengths[i] > binds[i].buffer_length)
+			{
+				std::string data;
+				data.resize(lengths[i]);
+
+				unsigned long length = 0;
+				MYSQL_BIND bind;
+				memset(&bind, 0, sizeof(MYSQL_BIND));
+				bind.buffer_type = MYSQL_TYPE_STRING;
+				bind.buffer = &data[0];
+				bind.buffer_length = data.size();
+				bind.length = &length;
+
+				if(mysql_stmt_fetch_column(pStmt, &bind, i, 0) != 0)
+				{
+					ret = false;
+					break;
+				}
+
+				data.resize(KBE_MIN(length, (unsigned long)data.size()));
+				results.push_back(data);
+				continue;
+			}
+
+			results.push_back(std::string(&buffers[i][0], lengths[i]));
+		}
+	}
+
+	if(!ret)
+	{
+		ERROR_MSG(boost::format("DBInterfaceMysql::fetchStmtResults: is error(%1%:%2%)!\nsql:(%3%)\n") % 
+			mysql_stmt_errno(pStmt) % mysql_stmt_error(pStmt) % lastquery_); 
+	}
+
+	mysql_stmt_free_result(pStmt);
+	return ret;
+}
+
+//-------------------------------------------------------------------------------------
+void DBInterfaceMysql::clearStmts()
+{
+	STMT_MAP::iterator iter = stmts_.begin();
+	for(; iter != stmts_.end(); iter++)
+		mysql_stmt_close(iter->second);
+
+	iter = dynamicStmts_.begin();
+	for(; iter != dynamicStmts_.end(); iter++)
+		mysql_stmt_close(iter->second);
+
+	stmts_.clear();
+	dynamicStmts_.clear();
+	entityStmtsPrepared_ = false;
+}
+
 //-------------------------------------------------------------------------------------
 bool DBInterfaceMysql::execute(const char* strCommand, uint32 size, MemoryStream * resdata)
 {
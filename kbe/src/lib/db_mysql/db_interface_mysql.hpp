@@ -42,6 +42,9 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 namespace KBEngine { 
 
+// ÿ໺ķentity̶(дд)
+#define MAX_CACHED_STMTS 1024
+
 struct TABLE_FIELD
 {
 	std::string name;
@@ -90,6 +93,24 @@ public:
 
 	bool execute(const char* strCommand, uint32 size, MemoryStream * resdata);
 
+	/**
+		ԤӰ󶨣 ÿӰsqlıһ
+		ÿentityĹ̶״ִʱһprepareפ(persistent) 
+		״ʹʱprepare MAX_CACHED_STMTSʱ̭
+		ִгɹ fetchStmtResultsȡ
+	*/
+	MYSQL_STMT* prepareStmt(const std::string& sql, bool persistent = false);
+	MYSQL_STMT* executeStmt(const std::string& sql, MYSQL_BIND* pParams, uint32 nparams);
+
+	/**
+		а˳results resultBindsÿе
+		ֵԭȡ űֽԭʼֵ ַȡ
+	*/
+	bool fetchStmtResults(MYSQL_STMT* pStmt, const std::vector<MYSQL_BIND>& resultBinds, 
+		std::vector<std::string>& results, uint32& nfields);
+
+	void clearStmts();
+
 	/**
 		ȡݿеı
 	*/
@@ -174,6 +195,18 @@ protected:
 
 	std::string characterSet_;
 	std::string collation_;
+
+	void prepareEntityStmts();
+
+	typedef KBEUnordered_map<std::string, MYSQL_STMT*> STMT_MAP;
+
+	// entityĹ̶䣬 ӶϿǰͷ
+	STMT_MAP stmts_;
+
+	// 
+	STMT_MAP dynamicStmts_;
+
+	bool entityStmtsPrepared_;
 };
 
 
@@ -23,6 +23,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "read_entity_helper.hpp"
 #include "write_entity_helper.hpp"
 #include "remove_entity_helper.hpp"
+#include "db_exception.hpp"
 #include "entitydef/scriptdef_module.hpp"
 #include "entitydef/property.hpp"
 #include "dbmgr_lib/db_interface.hpp"
@@ -35,6 +36,20 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 namespace KBEngine { 
 
+std::string SQL_SAVEPOINT = "SAVEPOINT kbe_write";
+std::string SQL_ROLLBACK_TO_SAVEPOINT = "ROLLBACK TO SAVEPOINT kbe_write";
+
+// ֵԭȡ datasΪֽԭʼֵ Ϊ(NULL)ʱд0
+template<typename T>
+static void addDigitToStream(MemoryStream* s, const std::string& datas)
+{
+	T v = 0;
+	if(datas.size() == sizeof(T))
+		memcpy(&v, datas.data(), sizeof(T));
+
+	(*s) << v;
+}
+std::string SQL_RELEASE_SAVEPOINT = "RELEASE SAVEPOINT kbe_write";
 
 bool sync_item_to_db(DBInterface* dbi, 
 					 const char* datatype, 
@@ -398,9 +413,9 @@ EntityTableItem* EntityTableMysql::createItem(std::string type)
 }
 
 //-------------------------------------------------------------------------------------
-DBID EntityTableMysql::writeTable(DBInterface* dbi, DBID dbid, MemoryStream* s, ScriptDefModule* pModule)
+bool EntityTableMysql::initWriteSqlItems(DBInterface* dbi, DBID dbid, MemoryStream* s, 
+	ScriptDefModule* pModule, DB_OP_TABLE_ITEM_DATA_BOX& opTableItemDataBox)
 {
-	DB_OP_TABLE_ITEM_DATA_BOX opTableItemDataBox;
 	opTableItemDataBox.parentTableName = "";
 	opTableItemDataBox.parentTableDBID = 0;
 	opTableItemDataBox.dbid = dbid;
@@ -408,6 +423,12 @@ DBID EntityTableMysql::writeTable(DBInterface* dbi, DBID dbid, MemoryStream* s,
 	opTableItemDataBox.isEmpty = false;
 	opTableItemDataBox.readresultIdx = 0;
 
+	// ϲдͬһԿֶܳΣ һεֵΪ׼
+	// ¼ÿԲitemsoptableķΧ ظʱ֮ǰķΧÿ
+	typedef std::pair<size_t, size_t> RANGE;
+	std::map<ENTITY_PROPERTY_UID, std::pair<RANGE, RANGE> > ranges;
+	bool hasDuplicate = false;
+
 	while(s->opsize() > 0)
 	{
 		ENTITY_PROPERTY_UID pid;
@@ -417,12 +438,60 @@ DBID EntityTableMysql::writeTable(DBInterface* dbi, DBID dbid, MemoryStream* s,
 		if(pTableItem == NULL)
 		{
 			ERROR_MSG(boost::format("EntityTable::writeTable: not found item[%1%].\n") % pid);
-			return dbid;
+			return false;
 		}
 		
+		size_t itemBegin = opTableItemDataBox.items.size();
+		size_t optableBegin = opTableItemDataBox.optable.size();
+
 		static_cast<EntityTableItemMysqlBase*>(pTableItem)->getWriteSqlItem(dbi, s, opTableItemDataBox);
+
+		std::map<ENTITY_PROPERTY_UID, std::pair<RANGE, RANGE> >::iterator iter = ranges.find(pid);
+		if(iter != ranges.end())
+		{
+			for(size_t i = iter->second.first.first; i < iter->second.first.second; i++)
+				opTableItemDataBox.items[i].reset();
+
+			for(size_t i = iter->second.second.first; i < iter->second.second.second; i++)
+				opTableItemDataBox.optable[i].second.reset();
+
+			hasDuplicate = true;
+		}
+
+		ranges[pid] = std::make_pair(RANGE(itemBegin, opTableItemDataBox.items.size()), 
+			RANGE(optableBegin, opTableItemDataBox.optable.size()));
 	};
 
+	if(hasDuplicate)
+	{
+		DB_OP_TABLE_ITEM_DATAS items;
+		for(size_t i = 0; i < opTableItemDataBox.items.size(); i++)
+		{
+			if(opTableItemDataBox.items[i])
+				items.push_back(opTableItemDataBox.items[i]);
+		}
+
+		DB_OP_TABLE_DATAS optable;
+		for(size_t i = 0; i < opTableItemDataBox.optable.size(); i++)
+		{
+			if(opTableItemDataBox.optable[i].second)
+				optable.push_back(opTableItemDataBox.optable[i]);
+		}
+
+		opTableItemDataBox.items.swap(items);
+		opTableItemDataBox.optable.swap(optable);
+	}
+
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+DBID EntityTableMysql::writeTable(DBInterface* dbi, DBID dbid, MemoryStream* s, ScriptDefModule* pModule)
+{
+	DB_OP_TABLE_ITEM_DATA_BOX opTableItemDataBox;
+	if(!initWriteSqlItems(dbi, dbid, s, pModule, opTableItemDataBox))
+		return dbid;
+
 	if(!WriteEntityHelper::writeDB(opTableItemDataBox.dbid > 0 ? TABLE_OP_UPDATE : TABLE_OP_INSERT, 
 		dbi, opTableItemDataBox))
 		return 0;
@@ -436,6 +505,135 @@ DBID EntityTableMysql::writeTable(DBInterface* dbi, DBID dbid, MemoryStream* s,
 	return dbid;
 }
 
+//-------------------------------------------------------------------------------------
+void EntityTableMysql::writeTables(DBInterface* dbi, const std::vector<DBID>& dbids, 
+	const std::vector<MemoryStream*>& streams, std::vector<bool>& results, ScriptDefModule* pModule)
+{
+	KBE_ASSERT(dbids.size() == streams.size());
+	results.assign(dbids.size(), false);
+
+	std::vector< KBEShared_ptr<DB_OP_TABLE_ITEM_DATA_BOX> > boxs(dbids.size());
+
+	// ֻд(漰ӱ)entityдз飬 д
+	std::map< std::string, std::vector<size_t> > groups;
+	std::vector<size_t> singles;
+
+	for(size_t i = 0; i < dbids.size(); i++)
+	{
+		KBE_ASSERT(dbids[i] > 0);
+
+		boxs[i].reset(new DB_OP_TABLE_ITEM_DATA_BOX());
+		DB_OP_TABLE_ITEM_DATA_BOX& opTableItemDataBox = *boxs[i];
+
+		if(!initWriteSqlItems(dbi, dbids[i], streams[i], pModule, opTableItemDataBox))
+			continue;
+
+		if(opTableItemDataBox.items.size() == 0 && opTableItemDataBox.optable.size() == 0)
+		{
+			// ûݸ
+			results[i] = true;
+			continue;
+		}
+
+		if(opTableItemDataBox.items.size() == 0 || opTableItemDataBox.optable.size() > 0)
+		{
+			singles.push_back(i);
+			continue;
+		}
+
+		std::string columns;
+		DB_OP_TABLE_ITEM_DATAS::iterator iter = opTableItemDataBox.items.begin();
+		for(; iter != opTableItemDataBox.items.end(); iter++)
+		{
+			columns += (*iter)->sqlkey;
+			columns += ",";
+		}
+
+		groups[columns].push_back(i);
+	}
+
+	std::map< std::string, std::vector<size_t> >::iterator groupIter = groups.begin();
+	for(; groupIter != groups.end(); groupIter++)
+	{
+		std::vector<size_t>& idxs = groupIter->second;
+		if(idxs.size() == 1)
+		{
+			singles.push_back(idxs[0]);
+			continue;
+		}
+
+		std::vector<DB_OP_TABLE_ITEM_DATA_BOX*> rows;
+		for(size_t i = 0; i < idxs.size(); i++)
+			rows.push_back(boxs[idxs[i]].get());
+
+		if(writeRows(dbi, rows))
+		{
+			for(size_t i = 0; i < idxs.size(); i++)
+				results[idxs[i]] = true;
+		}
+		else
+		{
+			singles.insert(singles.end(), idxs.begin(), idxs.end());
+		}
+	}
+
+	for(size_t i = 0; i < singles.size(); i++)
+	{
+		results[singles[i]] = writeBox(dbi, *boxs[singles[i]]);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableMysql::writeRows(DBInterface* dbi, std::vector<DB_OP_TABLE_ITEM_DATA_BOX*>& rows)
+{
+	dbi->query(SQL_SAVEPOINT, false);
+
+	try
+	{
+		SqlStatementUpdateRows sqlcmd(dbi, rows[0]->tableName, rows);
+		if(sqlcmd.query())
+		{
+			dbi->query(SQL_RELEASE_SAVEPOINT, false);
+			return true;
+		}
+	}
+	catch (DBException & e)
+	{
+		// ӶϿѾع ʧܽϲ㴦
+		if(e.isLostConnection() || e.shouldRetry())
+			throw;
+	}
+
+	dbi->query(SQL_ROLLBACK_TO_SAVEPOINT, false);
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+bool EntityTableMysql::writeBox(DBInterface* dbi, DB_OP_TABLE_ITEM_DATA_BOX& opTableItemDataBox)
+{
+	dbi->query(SQL_SAVEPOINT, false);
+
+	try
+	{
+		if(WriteEntityHelper::writeDB(TABLE_OP_UPDATE, dbi, opTableItemDataBox) && opTableItemDataBox.dbid > 0)
+		{
+			dbi->query(SQL_RELEASE_SAVEPOINT, false);
+			return true;
+		}
+	}
+	catch (DBException & e)
+	{
+		if(e.isLostConnection() || e.shouldRetry())
+			throw;
+	}
+
+	ERROR_MSG(boost::format("EntityTableMysql::writeBox: write %1%(%2%) is failed!\n") % 
+		opTableItemDataBox.tableName % opTableItemDataBox.dbid);
+
+	dbi->query(SQL_ROLLBACK_TO_SAVEPOINT, false);
+	return false;
+}
+
 //-------------------------------------------------------------------------------------
 bool EntityTableMysql::removeEntity(DBInterface* dbi, DBID dbid, ScriptDefModule* pModule)
 {
@@ -557,6 +755,36 @@ void EntityTableMysql::getReadSqlItem(DB_OP_TABLE_ITEM_DATA_BOX& opTableItemData
 	}
 }
 
+//-------------------------------------------------------------------------------------
+void EntityTableMysql::prepareStmts(DBInterface* dbi)
+{
+	DB_OP_TABLE_ITEM_DATA_BOX opTableItemDataBox;
+	opTableItemDataBox.parentTableDBID = 0;
+	opTableItemDataBox.dbid = 0;
+	opTableItemDataBox.isEmpty = true;
+	opTableItemDataBox.readresultIdx = 0;
+
+	std::vector<EntityTableItem*>::iterator iter = tableFixedOrderItems_.begin();
+	for(; iter != tableFixedOrderItems_.end(); iter++)
+	{
+		static_cast<EntityTableItemMysqlBase*>((*iter))->getReadSqlItem(opTableItemDataBox);
+	}
+
+	// ӱparentIDȡ룬 ֻҪı parentDBIDһ0ֵ
+	DBID parentDBID = isChild() ? 1 : 0;
+	DBInterfaceMysql* pdbi = static_cast<DBInterfaceMysql*>(dbi);
+
+	SqlStatementQuery query(dbi, tableName(), parentDBID, 0, opTableItemDataBox.items);
+	pdbi->prepareStmt(query.sql(), true);
+
+	SqlStatementInsert insert(dbi, tableName(), parentDBID, 0, opTableItemDataBox.items);
+	pdbi->prepareStmt(insert.sql(), true);
+
+	SqlStatementUpdate update(dbi, tableName(), parentDBID, 0, opTableItemDataBox.items);
+	if(update.sql().size() > 0)
+		pdbi->prepareStmt(update.sql(), true);
+}
+
 //-------------------------------------------------------------------------------------
 void EntityTableItemMysqlBase::init_db_item_name(const char* exstrFlag)
 {
@@ -595,11 +823,10 @@ void EntityTableItemMysql_VECTOR2::addToStream(MemoryStream* s, DB_OP_TABLE_ITEM
 	for(ArraySize i = 0; i < asize; i++)
 	{
 #ifdef CLIENT_NO_FLOAT
-		int32 v = atoi(opTableItemDataBox.results[opTableItemDataBox.readresultIdx++].c_str());
+		addDigitToStream<int32>(s, opTableItemDataBox.results[opTableItemDataBox.readresultIdx++]);
 #else
-		float v = (float)atof(opTableItemDataBox.results[opTableItemDataBox.readresultIdx++].c_str());
+		addDigitToStream<float>(s, opTableItemDataBox.results[opTableItemDataBox.readresultIdx++]);
 #endif
-		(*s) << v;
 	}
 }
 
@@ -627,9 +854,11 @@ void EntityTableItemMysql_VECTOR2::getWriteSqlItem(DBInterface* dbi, MemoryStrea
 		pSotvs->sqlkey = db_item_names_[i];
 
 #ifdef CLIENT_NO_FLOAT
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%d", v);
+		pSotvs->bindType = MYSQL_TYPE_LONG;
+		pSotvs->bindVal.i32 = v;
 #else
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%f", v);
+		pSotvs->bindType = MYSQL_TYPE_FLOAT;
+		pSotvs->bindVal.f = v;
 #endif
 		
 		opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
@@ -645,6 +874,13 @@ void EntityTableItemMysql_VECTOR2::getReadSqlItem(DB_OP_TABLE_ITEM_DATA_BOX& opT
 		DB_OP_TABLE_ITEM_DATA* pSotvs = new DB_OP_TABLE_ITEM_DATA();
 		pSotvs->sqlkey = db_item_names_[i];
 		memset(pSotvs->sqlval, 0, MAX_BUF);
+
+#ifdef CLIENT_NO_FLOAT
+		pSotvs->bindType = MYSQL_TYPE_LONG;
+#else
+		pSotvs->bindType = MYSQL_TYPE_FLOAT;
+#endif
+
 		opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
 	}
 }
@@ -685,11 +921,10 @@ void EntityTableItemMysql_VECTOR3::addToStream(MemoryStream* s, DB_OP_TABLE_ITEM
 	for(ArraySize i = 0; i < asize; i++)
 	{
 #ifdef CLIENT_NO_FLOAT
-		int32 v = atoi(opTableItemDataBox.results[opTableItemDataBox.readresultIdx++].c_str());
+		addDigitToStream<int32>(s, opTableItemDataBox.results[opTableItemDataBox.readresultIdx++]);
 #else
-		float v = (float)atof(opTableItemDataBox.results[opTableItemDataBox.readresultIdx++].c_str());
+		addDigitToStream<float>(s, opTableItemDataBox.results[opTableItemDataBox.readresultIdx++]);
 #endif
-		(*s) << v;
 	}
 }
 
@@ -717,9 +952,11 @@ void EntityTableItemMysql_VECTOR3::getWriteSqlItem(DBInterface* dbi, MemoryStrea
 		pSotvs->sqlkey = db_item_names_[i];
 
 #ifdef CLIENT_NO_FLOAT
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%d", v);
+		pSotvs->bindType = MYSQL_TYPE_LONG;
+		pSotvs->bindVal.i32 = v;
 #else
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%f", v);
+		pSotvs->bindType = MYSQL_TYPE_FLOAT;
+		pSotvs->bindVal.f = v;
 #endif
 
 		opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
@@ -735,6 +972,13 @@ void EntityTableItemMysql_VECTOR3::getReadSqlItem(DB_OP_TABLE_ITEM_DATA_BOX& opT
 		DB_OP_TABLE_ITEM_DATA* pSotvs = new DB_OP_TABLE_ITEM_DATA();
 		pSotvs->sqlkey = db_item_names_[i];
 		memset(pSotvs->sqlval, 0, MAX_BUF);
+
+#ifdef CLIENT_NO_FLOAT
+		pSotvs->bindType = MYSQL_TYPE_LONG;
+#else
+		pSotvs->bindType = MYSQL_TYPE_FLOAT;
+#endif
+
 		opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
 	}
 }
@@ -775,11 +1019,10 @@ void EntityTableItemMysql_VECTOR4::addToStream(MemoryStream* s, DB_OP_TABLE_ITEM
 	for(ArraySize i = 0; i < asize; i++)
 	{
 #ifdef CLIENT_NO_FLOAT
-		int32 v = atoi(opTableItemDataBox.results[opTableItemDataBox.readresultIdx++].c_str());
+		addDigitToStream<int32>(s, opTableItemDataBox.results[opTableItemDataBox.readresultIdx++]);
 #else
-		float v = (float)atof(opTableItemDataBox.results[opTableItemDataBox.readresultIdx++].c_str());
+		addDigitToStream<float>(s, opTableItemDataBox.results[opTableItemDataBox.readresultIdx++]);
 #endif
-		(*s) << v;
 	}
 }
 
@@ -807,9 +1050,11 @@ void EntityTableItemMysql_VECTOR4::getWriteSqlItem(DBInterface* dbi, MemoryStrea
 		pSotvs->sqlkey = db_item_names_[i];
 
 #ifdef CLIENT_NO_FLOAT
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%d", v);
+		pSotvs->bindType = MYSQL_TYPE_LONG;
+		pSotvs->bindVal.i32 = v;
 #else
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%f", v);
+		pSotvs->bindType = MYSQL_TYPE_FLOAT;
+		pSotvs->bindVal.f = v;
 #endif
 
 		opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
@@ -825,6 +1070,13 @@ void EntityTableItemMysql_VECTOR4::getReadSqlItem(DB_OP_TABLE_ITEM_DATA_BOX& opT
 		DB_OP_TABLE_ITEM_DATA* pSotvs = new DB_OP_TABLE_ITEM_DATA();
 		pSotvs->sqlkey = db_item_names_[i];
 		memset(pSotvs->sqlval, 0, MAX_BUF);
+
+#ifdef CLIENT_NO_FLOAT
+		pSotvs->bindType = MYSQL_TYPE_LONG;
+#else
+		pSotvs->bindType = MYSQL_TYPE_FLOAT;
+#endif
+
 		opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
 	}
 }
@@ -1149,71 +1401,47 @@ bool EntityTableItemMysql_DIGIT::syncToDB(DBInterface* dbi, void* pData)
 //-------------------------------------------------------------------------------------
 void EntityTableItemMysql_DIGIT::addToStream(MemoryStream* s, DB_OP_TABLE_ITEM_DATA_BOX& opTableItemDataBox, DBID resultDBID)
 {
-	std::stringstream stream;
-	stream << opTableItemDataBox.results[opTableItemDataBox.readresultIdx++];
+	const std::string& datas = opTableItemDataBox.results[opTableItemDataBox.readresultIdx++];
 
 	if(dataSType_ == "INT8")
-	{
-		int32 v;
-		stream >> v;
-		int8 vv = static_cast<int8>(v);
-		(*s) << vv;
-	}
+		addDigitToStream<int8>(s, datas);
 	else if(dataSType_ == "INT16")
-	{
-		int16 v;
-		stream >> v;
-		(*s) << v;
-	}
+		addDigitToStream<int16>(s, datas);
 	else if(dataSType_ == "INT32")
-	{
-		int32 v;
-		stream >> v;
-		(*s) << v;
-	}
+		addDigitToStream<int32>(s, datas);
 	else if(dataSType_ == "INT64")
-	{
-		int64 v;
-		stream >> v;
-		(*s) << v;
-	}
+		addDigitToStream<int64>(s, datas);
 	else if(dataSType_ == "UINT8")
-	{
-		int32 v;
-		stream >> v;
-		uint8 vv = static_cast<uint8>(v);
-		(*s) << vv;
-	}
+		addDigitToStream<uint8>(s, datas);
 	else if(dataSType_ == "UINT16")
-	{
-		uint16 v;
-		stream >> v;
-		(*s) << v;
-	}
+		addDigitToStream<uint16>(s, datas);
 	else if(dataSType_ == "UINT32")
-	{
-		uint32 v;
-		stream >> v;
-		(*s) << v;
-	}
+		addDigitToStream<uint32>(s, datas);
 	else if(dataSType_ == "UINT64")
-	{
-		uint64 v;
-		stream >> v;
-		(*s) << v;
-	}
+		addDigitToStream<uint64>(s, datas);
 	else if(dataSType_ == "FLOAT")
-	{
-		float v;
-		stream >> v;
-		(*s) << v;
-	}
+		addDigitToStream<float>(s, datas);
 	else if(dataSType_ == "DOUBLE")
-	{
-		double v;
-		stream >> v;
-		(*s) << v;
-	}
+		addDigitToStream<double>(s, datas);
+}
+
+//-------------------------------------------------------------------------------------
+void EntityTableItemMysql_DIGIT::initBindType(DB_OP_TABLE_ITEM_DATA* pSotvs)
+{
+	pSotvs->bindUnsigned = dataSType_[0] == 'U';
+
+	if(dataSType_ == "INT8" || dataSType_ == "UINT8")
+		pSotvs->bindType = MYSQL_TYPE_TINY;
+	else if(dataSType_ == "INT16" || dataSType_ == "UINT16")
+		pSotvs->bindType = MYSQL_TYPE_SHORT;
+	else if(dataSType_ == "INT32" || dataSType_ == "UINT32")
+		pSotvs->bindType = MYSQL_TYPE_LONG;
+	else if(dataSType_ == "INT64" || dataSType_ == "UINT64")
+		pSotvs->bindType = MYSQL_TYPE_LONGLONG;
+	else if(dataSType_ == "FLOAT")
+		pSotvs->bindType = MYSQL_TYPE_FLOAT;
+	else if(dataSType_ == "DOUBLE")
+		pSotvs->bindType = MYSQL_TYPE_DOUBLE;
 }
 
 //-------------------------------------------------------------------------------------
@@ -1223,71 +1451,31 @@ void EntityTableItemMysql_DIGIT::getWriteSqlItem(DBInterface* dbi, MemoryStream*
 		return;
 
 	DB_OP_TABLE_ITEM_DATA* pSotvs = new DB_OP_TABLE_ITEM_DATA();
-	
+	initBindType(pSotvs);
+
 	if(dataSType_ == "INT8")
-	{
-		int8 v;
-		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%d", v);
-	}
+		(*s) >> pSotvs->bindVal.i8;
 	else if(dataSType_ == "INT16")
-	{
-		int16 v;
-		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%d", v);
-	}
+		(*s) >> pSotvs->bindVal.i16;
 	else if(dataSType_ == "INT32")
-	{
-		int32 v;
-		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%d", v);
-	}
+		(*s) >> pSotvs->bindVal.i32;
 	else if(dataSType_ == "INT64")
-	{
-		int64 v;
-		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%"PRI64, v);
-	}
+		(*s) >> pSotvs->bindVal.i64;
 	else if(dataSType_ == "UINT8")
-	{
-		uint8 v;
-		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%u", v);
-	}
+		(*s) >> pSotvs->bindVal.u8;
 	else if(dataSType_ == "UINT16")
-	{
-		uint16 v;
-		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%u", v);
-	}
+		(*s) >> pSotvs->bindVal.u16;
 	else if(dataSType_ == "UINT32")
-	{
-		uint32 v;
-		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%u", v);
-	}
+		(*s) >> pSotvs->bindVal.u32;
 	else if(dataSType_ == "UINT64")
-	{
-		uint64 v;
-		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%"PRIu64, v);
-	}
+		(*s) >> pSotvs->bindVal.u64;
 	else if(dataSType_ == "FLOAT")
-	{
-		float v;
-		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%f", v);
-	}
+		(*s) >> pSotvs->bindVal.f;
 	else if(dataSType_ == "DOUBLE")
-	{
-		double v;
-		(*s) >> v;
-		kbe_snprintf(pSotvs->sqlval, MAX_BUF, "%lf", v);
-	}
+		(*s) >> pSotvs->bindVal.d;
 
 	pSotvs->sqlkey = db_item_name();
 	opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
-	
 }
 
 //-------------------------------------------------------------------------------------
@@ -1296,6 +1484,7 @@ void EntityTableItemMysql_DIGIT::getReadSqlItem(DB_OP_TABLE_ITEM_DATA_BOX& opTab
 	DB_OP_TABLE_ITEM_DATA* pSotvs = new DB_OP_TABLE_ITEM_DATA();
 	pSotvs->sqlkey = db_item_name();
 	memset(pSotvs->sqlval, 0, MAX_BUF);
+	initBindType(pSotvs);
 	opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
 }
 
@@ -1334,23 +1523,9 @@ void EntityTableItemMysql_STRING::getWriteSqlItem(DBInterface* dbi,
 
 	DB_OP_TABLE_ITEM_DATA* pSotvs = new DB_OP_TABLE_ITEM_DATA();
 
-	std::string val;
-	(*s) >> val;
-
-	pSotvs->extraDatas = "\"";
+	(*s) >> pSotvs->bindData;
+	pSotvs->bindType = MYSQL_TYPE_STRING;
 
-	char* tbuf = new char[val.size() * 2 + 1];
-	memset(tbuf, 0, val.size() * 2 + 1);
-
-	mysql_real_escape_string(static_cast<DBInterfaceMysql*>(dbi)->mysql(), 
-		tbuf, val.c_str(), val.size());
-
-	pSotvs->extraDatas += tbuf;
-	pSotvs->extraDatas += "\"";
-
-	SAFE_RELEASE_ARRAY(tbuf);
-
-	memset(pSotvs, 0, sizeof(pSotvs->sqlval));
 	pSotvs->sqlkey = db_item_name();
 	opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
 }
@@ -1361,6 +1536,7 @@ void EntityTableItemMysql_STRING::getReadSqlItem(DB_OP_TABLE_ITEM_DATA_BOX& opTa
 	DB_OP_TABLE_ITEM_DATA* pSotvs = new DB_OP_TABLE_ITEM_DATA();
 	pSotvs->sqlkey = db_item_name();
 	memset(pSotvs->sqlval, 0, MAX_BUF);
+	pSotvs->bindType = MYSQL_TYPE_STRING;
 	opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
 }
 
@@ -1399,21 +1575,9 @@ void EntityTableItemMysql_UNICODE::getWriteSqlItem(DBInterface* dbi, MemoryStrea
 
 	DB_OP_TABLE_ITEM_DATA* pSotvs = new DB_OP_TABLE_ITEM_DATA();
 
-	std::string val;
-	s->readBlob(val);
-
-	char* tbuf = new char[val.size() * 2 + 1];
-	memset(tbuf, 0, val.size() * 2 + 1);
-
-	mysql_real_escape_string(static_cast<DBInterfaceMysql*>(dbi)->mysql(), 
-		tbuf, val.c_str(), val.size());
-	
-	pSotvs->extraDatas = "\"";
-	pSotvs->extraDatas += tbuf;
-	pSotvs->extraDatas += "\"";
-	SAFE_RELEASE_ARRAY(tbuf);
+	s->readBlob(pSotvs->bindData);
+	pSotvs->bindType = MYSQL_TYPE_STRING;
 
-	memset(pSotvs, 0, sizeof(pSotvs->sqlval));
 	pSotvs->sqlkey = db_item_name();
 	opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
 }
@@ -1424,6 +1588,7 @@ void EntityTableItemMysql_UNICODE::getReadSqlItem(DB_OP_TABLE_ITEM_DATA_BOX& opT
 	DB_OP_TABLE_ITEM_DATA* pSotvs = new DB_OP_TABLE_ITEM_DATA();
 	pSotvs->sqlkey = db_item_name();
 	memset(pSotvs->sqlval, 0, MAX_BUF);
+	pSotvs->bindType = MYSQL_TYPE_STRING;
 	opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
 }
 
@@ -1449,21 +1614,9 @@ void EntityTableItemMysql_BLOB::getWriteSqlItem(DBInterface* dbi, MemoryStream*
 
 	DB_OP_TABLE_ITEM_DATA* pSotvs = new DB_OP_TABLE_ITEM_DATA();
 
-	std::string val;
-	s->readBlob(val);
+	s->readBlob(pSotvs->bindData);
+	pSotvs->bindType = MYSQL_TYPE_BLOB;
 
-	char* tbuf = new char[val.size() * 2 + 1];
-	memset(tbuf, 0, val.size() * 2 + 1);
-
-	mysql_real_escape_string(static_cast<DBInterfaceMysql*>(dbi)->mysql(), 
-		tbuf, val.data(), val.size());
-
-	pSotvs->extraDatas = "\"";
-	pSotvs->extraDatas += tbuf;
-	pSotvs->extraDatas += "\"";
-	SAFE_RELEASE_ARRAY(tbuf);
-
-	memset(pSotvs, 0, sizeof(pSotvs->sqlval));
 	pSotvs->sqlkey = db_item_name();
 	opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
 }
@@ -1474,6 +1627,7 @@ void EntityTableItemMysql_BLOB::getReadSqlItem(DB_OP_TABLE_ITEM_DATA_BOX& opTabl
 	DB_OP_TABLE_ITEM_DATA* pSotvs = new DB_OP_TABLE_ITEM_DATA();
 	pSotvs->sqlkey = db_item_name();
 	memset(pSotvs->sqlval, 0, MAX_BUF);
+	pSotvs->bindType = MYSQL_TYPE_BLOB;
 	opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
 }
 
@@ -1499,21 +1653,9 @@ void EntityTableItemMysql_PYTHON::getWriteSqlItem(DBInterface* dbi, MemoryStream
 
 	DB_OP_TABLE_ITEM_DATA* pSotvs = new DB_OP_TABLE_ITEM_DATA();
 
-	std::string val;
-	s->readBlob(val);
-
-	char* tbuf = new char[val.size() * 2 + 1];
-	memset(tbuf, 0, val.size() * 2 + 1);
-
-	mysql_real_escape_string(static_cast<DBInterfaceMysql*>(dbi)->mysql(), 
-		tbuf, val.c_str(), val.size());
-
-	pSotvs->extraDatas = "\"";
-	pSotvs->extraDatas += tbuf;
-	pSotvs->extraDatas += "\"";
-	SAFE_RELEASE_ARRAY(tbuf);
+	s->readBlob(pSotvs->bindData);
+	pSotvs->bindType = MYSQL_TYPE_BLOB;
 
-	memset(pSotvs, 0, sizeof(pSotvs->sqlval));
 	pSotvs->sqlkey = db_item_name();
 	opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
 }
@@ -1524,6 +1666,7 @@ void EntityTableItemMysql_PYTHON::getReadSqlItem(DB_OP_TABLE_ITEM_DATA_BOX& opTa
 	DB_OP_TABLE_ITEM_DATA* pSotvs = new DB_OP_TABLE_ITEM_DATA();
 	pSotvs->sqlkey = db_item_name();
 	memset(pSotvs->sqlval, 0, MAX_BUF);
+	pSotvs->bindType = MYSQL_TYPE_BLOB;
 	opTableItemDataBox.items.push_back(KBEShared_ptr<DB_OP_TABLE_ITEM_DATA>(pSotvs));
 }
 
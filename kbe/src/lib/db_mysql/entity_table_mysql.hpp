@@ -124,6 +124,8 @@ public:
 	virtual void getWriteSqlItem(DBInterface* dbi, MemoryStream* s, DB_OP_TABLE_ITEM_DATA_BOX& opTableItemDataBox);
 	virtual void getReadSqlItem(DB_OP_TABLE_ITEM_DATA_BOX& opTableItemDataBox);
 protected:
+	void initBindType(DB_OP_TABLE_ITEM_DATA* pSotvs);
+
 	std::string dataSType_;
 };
 
@@ -515,6 +517,13 @@ public:
 
 	DBID writeTable(DBInterface* dbi, DBID dbid, MemoryStream* s, ScriptDefModule* pModule);
 
+	/**
+		£ дͬеentityϲΪһ䣬 
+		ÿдʧʱع㲢дȷʧܵentity
+	*/
+	virtual void writeTables(DBInterface* dbi, const std::vector<DBID>& dbids, 
+		const std::vector<MemoryStream*>& streams, std::vector<bool>& results, ScriptDefModule* pModule);
+
 	/**
 		ݿɾentity
 	*/
@@ -536,9 +545,18 @@ public:
 	virtual void getWriteSqlItem(DBInterface* dbi, MemoryStream* s, DB_OP_TABLE_ITEM_DATA_BOX& opTableItemDataBox);
 	virtual void getReadSqlItem(DB_OP_TABLE_ITEM_DATA_BOX& opTableItemDataBox);
 
+	/**
+		prepare̶Ķд
+	*/
+	void prepareStmts(DBInterface* dbi);
+
 	void init_db_item_name();
 protected:
-	
+	bool initWriteSqlItems(DBInterface* dbi, DBID dbid, MemoryStream* s, 
+		ScriptDefModule* pModule, DB_OP_TABLE_ITEM_DATA_BOX& opTableItemDataBox);
+
+	bool writeRows(DBInterface* dbi, std::vector<DB_OP_TABLE_ITEM_DATA_BOX*>& rows);
+	bool writeBox(DBInterface* dbi, DB_OP_TABLE_ITEM_DATA_BOX& opTableItemDataBox);
 };
 
 
@@ -23,7 +23,6 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 // common include	
 // #define NDEBUG
-#include <sstream>
 #include "common.hpp"
 #include "sqlstatement.hpp"
 #include "entity_sqlstatement_mapping.hpp"
@@ -52,55 +51,43 @@ public:
 	*/
 	static bool queryDB(DBInterface* dbi, DB_OP_TABLE_ITEM_DATA_BOX& opTableItemDataBox)
 	{
-		SqlStatement* pSqlcmd = new SqlStatementQuery(dbi, opTableItemDataBox.tableName, 
+		SqlStatementQuery* pSqlcmd = new SqlStatementQuery(dbi, opTableItemDataBox.tableName, 
 			opTableItemDataBox.parentTableDBID, 
 			opTableItemDataBox.dbid, opTableItemDataBox.items);
 
 		bool ret = pSqlcmd->query();
 		opTableItemDataBox.dbid = pSqlcmd->dbid();
-		delete pSqlcmd;
 		
 		if(!ret)
+		{
+			delete pSqlcmd;
 			return ret;
+		}
 
-		MYSQL_RES * pResult = mysql_store_result(static_cast<DBInterfaceMysql*>(dbi)->mysql());
+		std::vector<std::string>& results = pSqlcmd->results();
+		uint32 nfields = pSqlcmd->nfields();
 
-		if(pResult)
+		if(nfields > 0)
 		{
-			MYSQL_ROW arow;
+			KBE_ASSERT(nfields == opTableItemDataBox.items.size() + 1);
 
-			while((arow = mysql_fetch_row(pResult)) != NULL)
+			for(std::vector<std::string>::size_type row = 0; row < results.size(); row += nfields)
 			{
-				uint32 nfields = (uint32)mysql_num_fields(pResult);
-				if(nfields <= 0)
-					continue;
-
-				unsigned long *lengths = mysql_fetch_lengths(pResult);
+				DBID item_dbid = 0;
+				KBE_ASSERT(results[row].size() == sizeof(DBID));
+				memcpy(&item_dbid, results[row].data(), sizeof(DBID));
 
-				std::stringstream sval;
-				sval << arow[0];
-				DBID item_dbid;
-				
-				sval >> item_dbid;
 				opTableItemDataBox.dbids[opTableItemDataBox.parentTableDBID > 0 ? 
 							opTableItemDataBox.parentTableDBID : opTableItemDataBox.dbid].push_back(item_dbid);
 
-				if(nfields > 1)
+				for (uint32 i = 1; i < nfields; i++)
 				{
-					KBE_ASSERT(nfields == opTableItemDataBox.items.size() + 1);
-					for (uint32 i = 1; i < nfields; i++)
-					{
-						KBEShared_ptr<DB_OP_TABLE_ITEM_DATA> pSotvs = opTableItemDataBox.items[i - 1];
-						std::string data;
-						data.assign(arow[i], lengths[i]);
-
-						opTableItemDataBox.results.push_back(data);
-					}
+					opTableItemDataBox.results.push_back(results[row + i]);
 				}
 			}
-
-			mysql_free_result(pResult);
 		}
+
+		delete pSqlcmd;
 		
 		std::vector<DBID>& dbids = opTableItemDataBox.dbids[opTableItemDataBox.parentTableDBID > 0 ? 
 							opTableItemDataBox.parentTableDBID : opTableItemDataBox.dbid];
@@ -34,6 +34,10 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 namespace KBEngine{ 
 
+/*
+	䶼ԤķʽִУ ֵͨ󶨴ݣ Ҫתƴı
+	ͬṹÿֻprepareһ
+*/
 class SqlStatement
 {
 public:
@@ -44,7 +48,9 @@ public:
 	  tableName_(tableName),
 	  dbid_(dbid),
 	  parentDBID_(parentDBID),
-	  dbi_(dbi)
+	  dbi_(dbi),
+	  binds_(),
+	  pStmt_(NULL)
 	{
 	}
 
@@ -60,9 +66,10 @@ public:
 		if(sqlstr_ == "")
 			return true;
 
-		bool ret = static_cast<DBInterfaceMysql*>(dbi != NULL ? dbi : dbi_)->query(sqlstr_.c_str(), sqlstr_.size(), false);
+		pStmt_ = static_cast<DBInterfaceMysql*>(dbi != NULL ? dbi : dbi_)->executeStmt(sqlstr_, 
+			binds_.size() > 0 ? &binds_[0] : NULL, binds_.size());
 
-		if(!ret)
+		if(pStmt_ == NULL)
 		{
 			ERROR_MSG(boost::format("SqlStatement::query: %1%\n\tsql:%2%\n") % 
 				(dbi != NULL ? dbi : dbi_)->getstrerror() % sqlstr_);
@@ -70,17 +77,52 @@ public:
 			return false;
 		}
 
-		return ret;
+		return true;
 	}
 
 	DBID dbid()const{ return dbid_; }
 protected:
+	void bindItem(DB_OP_TABLE_ITEM_DATA* pSotvs)
+	{
+		MYSQL_BIND bind;
+		memset(&bind, 0, sizeof(bind));
+
+		bind.buffer_type = pSotvs->bindType;
+		bind.is_unsigned = pSotvs->bindUnsigned;
+
+		if(pSotvs->bindType == MYSQL_TYPE_STRING || pSotvs->bindType == MYSQL_TYPE_BLOB)
+		{
+			bind.buffer = const_cast<char*>(pSotvs->bindData.data());
+			bind.buffer_length = pSotvs->bindData.size();
+		}
+		else
+		{
+			bind.buffer = &pSotvs->bindVal;
+		}
+
+		binds_.push_back(bind);
+	}
+
+	void bindDBID(DBID* pdbid)
+	{
+		MYSQL_BIND bind;
+		memset(&bind, 0, sizeof(bind));
+
+		bind.buffer_type = MYSQL_TYPE_LONGLONG;
+		bind.is_unsigned = true;
+		bind.buffer = pdbid;
+		binds_.push_back(bind);
+	}
+
 	DB_OP_TABLE_ITEM_DATAS& tableItemDatas_;
 	std::string sqlstr_;
 	std::string tableName_;
 	DBID dbid_;
 	DBID parentDBID_;
 	DBInterface* dbi_; 
+
+	std::vector<MYSQL_BIND> binds_;
+	MYSQL_STMT* pStmt_;
 };
 
 class SqlStatementInsert : public SqlStatement
@@ -90,7 +132,7 @@ public:
 		DBID dbid, DB_OP_TABLE_ITEM_DATAS& tableItemDatas):
 	  SqlStatement(dbi, tableName, parentDBID, dbid, tableItemDatas)
 	{
-		// insert into tbl_Account (sm_accountName) values("fdsafsad\0\fdsfasfsa\0fdsafsda");
+		// insert into tbl_Account (sm_accountName) values(?);
 		sqlstr_ = "insert into "ENTITY_TABLE_PERFIX"_";
 		sqlstr_ += tableName;
 		sqlstr_ += " (";
@@ -100,11 +142,8 @@ public:
 		{
 			sqlstr_ += TABLE_PARENTID_CONST_STR;
 			sqlstr_ += ",";
-			
-			char strdbid[MAX_BUF];
-			kbe_snprintf(strdbid, MAX_BUF, "%"PRDBID, parentDBID);
-			sqlstr1_ += strdbid;
-			sqlstr1_ += ",";
+			sqlstr1_ += "?,";
+			bindDBID(&parentDBID_);
 		}
 
 		DB_OP_TABLE_ITEM_DATAS::iterator tableValIter = tableItemDatas.begin();
@@ -118,10 +157,8 @@ public:
 			else
 			{
 				sqlstr_ += pSotvs->sqlkey;
-				if(pSotvs->extraDatas.size() > 0)
-					sqlstr1_ += pSotvs->extraDatas;
-				else
-					sqlstr1_ += pSotvs->sqlval;
+				sqlstr1_ += "?";
+				bindItem(pSotvs.get());
 
 				sqlstr_ += ",";
 				sqlstr1_ += ",";
@@ -157,7 +194,7 @@ public:
 			return false;
 		}
 
-		dbid_ = static_cast<DBInterfaceMysql*>(dbi != NULL ? dbi : dbi_)->insertID();
+		dbid_ = mysql_stmt_insert_id(pStmt_);
 		return ret;
 	}
 
@@ -179,7 +216,8 @@ public:
 			return;
 		}
 
-		// update tbl_Account set sm_accountName="fdsafsad" where id=123;
+		// ֻдı˵ʱеϸͬ ÿ϶ӦһԤ
+		// update tbl_Account set sm_accountName=? where id=?;
 		sqlstr_ = "update "ENTITY_TABLE_PERFIX"_";
 		sqlstr_ += tableName;
 		sqlstr_ += " set ";
@@ -190,24 +228,15 @@ public:
 			KBEShared_ptr<DB_OP_TABLE_ITEM_DATA> pSotvs = (*tableValIter);
 			
 			sqlstr_ += pSotvs->sqlkey;
-			sqlstr_ += "=";
-				
-			if(pSotvs->extraDatas.size() > 0)
-				sqlstr_ += pSotvs->extraDatas;
-			else
-				sqlstr_ += pSotvs->sqlval;
-
-			sqlstr_ += ",";
+			sqlstr_ += "=?,";
+			bindItem(pSotvs.get());
 		}
 
 		if(sqlstr_.at(sqlstr_.size() - 1) == ',')
 			sqlstr_.erase(sqlstr_.size() - 1);
 
-		sqlstr_ += " where id=";
-		
-		char strdbid[MAX_BUF];
-		kbe_snprintf(strdbid, MAX_BUF, "%"PRDBID, dbid);
-		sqlstr_ += strdbid;
+		sqlstr_ += " where id=?";
+		bindDBID(&dbid_);
 	}
 
 	virtual ~SqlStatementUpdate()
@@ -216,37 +245,91 @@ public:
 protected:
 };
 
+class SqlStatementUpdateRows : public SqlStatement
+{
+public:
+	SqlStatementUpdateRows(DBInterface* dbi, std::string tableName, 
+		std::vector<DB_OP_TABLE_ITEM_DATA_BOX*>& rows):
+	  SqlStatement(dbi, tableName, 0, 0, rows[0]->items)
+	{
+		// дͬ 뵥еupdateһᴴѾڵ
+		// update tbl_Avatar set sm_level=case id when ? then ? when ? then ? end where id in (?,?);
+		sqlstr_ = "update "ENTITY_TABLE_PERFIX"_";
+		sqlstr_ += tableName;
+		sqlstr_ += " set ";
+
+		for(size_t i = 0; i < rows.size(); i++)
+			KBE_ASSERT(rows[i]->items.size() == tableItemDatas_.size());
+
+		for(size_t col = 0; col < tableItemDatas_.size(); col++)
+		{
+			if(col > 0)
+				sqlstr_ += ",";
+
+			sqlstr_ += tableItemDatas_[col]->sqlkey;
+			sqlstr_ += "=case "TABLE_ID_CONST_STR;
+
+			for(size_t i = 0; i < rows.size(); i++)
+			{
+				sqlstr_ += " when ? then ?";
+				bindDBID(&rows[i]->dbid);
+				bindItem(rows[i]->items[col].get());
+			}
+
+			sqlstr_ += " end";
+		}
+
+		sqlstr_ += " where "TABLE_ID_CONST_STR" in (";
+
+		for(size_t i = 0; i < rows.size(); i++)
+		{
+			if(i > 0)
+				sqlstr_ += ",";
+
+			sqlstr_ += "?";
+			bindDBID(&rows[i]->dbid);
+		}
+
+		sqlstr_ += ")";
+	}
+
+	virtual ~SqlStatementUpdateRows()
+	{
+	}
+protected:
+};
+
 class SqlStatementQuery : public SqlStatement
 {
 public:
 	SqlStatementQuery(DBInterface* dbi, std::string tableName, DBID parentDBID, 
 		DBID dbid, DB_OP_TABLE_ITEM_DATAS& tableItemDatas):
 	  SqlStatement(dbi, tableName, parentDBID, dbid, tableItemDatas),
-	  sqlstr1_()
+	  sqlstr1_(),
+	  resultBinds_(),
+	  results_(),
+	  nfields_(0)
 	{
 
-		// select id,xxx from tbl_SpawnPoint where id=123;
+		// select id,xxx from tbl_SpawnPoint where id=?;
 		sqlstr_ = "select ";
 		sqlstr1_ += " from "ENTITY_TABLE_PERFIX"_";
 		sqlstr1_ += tableName;
 		
-		char strdbid[MAX_BUF];
-
 		if(parentDBID <= 0)
 		{
-			sqlstr1_ += " where id=";
-			kbe_snprintf(strdbid, MAX_BUF, "%"PRDBID, dbid);
+			sqlstr1_ += " where id=?";
+			bindDBID(&dbid_);
 		}
 		else
 		{
-			sqlstr1_ += " where "TABLE_PARENTID_CONST_STR"=";
-			kbe_snprintf(strdbid, MAX_BUF, "%"PRDBID, parentDBID);
+			sqlstr1_ += " where "TABLE_PARENTID_CONST_STR"=?";
+			bindDBID(&parentDBID_);
 		}
 		
 		// ѯIDֶ
 		sqlstr_ += "id,";
-
-		sqlstr1_ += strdbid;
+		bindResult(MYSQL_TYPE_LONGLONG, true);
 
 		DB_OP_TABLE_ITEM_DATAS::iterator tableValIter = tableItemDatas.begin();
 		for(; tableValIter != tableItemDatas.end(); tableValIter++)
@@ -255,6 +338,7 @@ public:
 			
 			sqlstr_ += pSotvs->sqlkey;
 			sqlstr_ += ",";
+			bindResult(pSotvs->bindType, pSotvs->bindUnsigned);
 		}
 
 		if(sqlstr_.at(sqlstr_.size() - 1) == ',')
@@ -266,8 +350,37 @@ public:
 	virtual ~SqlStatementQuery()
 	{
 	}
+
+	virtual bool query(DBInterface* dbi = NULL)
+	{
+		if(!SqlStatement::query(dbi))
+			return false;
+
+		return static_cast<DBInterfaceMysql*>(dbi != NULL ? dbi : dbi_)->fetchStmtResults(pStmt_, 
+			resultBinds_, results_, nfields_);
+	}
+
+	/**
+		а˳ţ ÿnfieldsֵ
+		ֵΪֽԭʼֵ һΪid
+	*/
+	std::vector<std::string>& results(){ return results_; }
+	uint32 nfields()const{ return nfields_; }
 protected:
+	void bindResult(enum_field_types type, bool isUnsigned)
+	{
+		MYSQL_BIND bind;
+		memset(&bind, 0, sizeof(bind));
+
+		bind.buffer_type = type;
+		bind.is_unsigned = isUnsigned;
+		resultBinds_.push_back(bind);
+	}
+
 	std::string sqlstr1_;
+	std::vector<MYSQL_BIND> resultBinds_;
+	std::vector<std::string> results_;
+	uint32 nfields_;
 };
 
 }
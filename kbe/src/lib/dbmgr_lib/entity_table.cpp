@@ -72,6 +72,19 @@ DBID EntityTable::writeTable(DBInterface* dbi, DBID dbid, MemoryStream* s, Scrip
 	return dbid;
 }
 
+//-------------------------------------------------------------------------------------
+void EntityTable::writeTables(DBInterface* dbi, const std::vector<DBID>& dbids, 
+	const std::vector<MemoryStream*>& streams, std::vector<bool>& results, ScriptDefModule* pModule)
+{
+	KBE_ASSERT(dbids.size() == streams.size());
+	results.assign(dbids.size(), false);
+
+	for(size_t i = 0; i < dbids.size(); i++)
+	{
+		results[i] = writeTable(dbi, dbids[i], streams[i], pModule) > 0;
+	}
+}
+
 //-------------------------------------------------------------------------------------
 bool EntityTable::removeEntity(DBInterface* dbi, DBID dbid, ScriptDefModule* pModule)
 {
@@ -279,6 +292,16 @@ DBID EntityTables::writeEntity(DBInterface* dbi, DBID dbid, MemoryStream* s, Scr
 	return pTable->writeTable(dbi, dbid, s, pModule);
 }
 
+//-------------------------------------------------------------------------------------
+void EntityTables::writeEntities(DBInterface* dbi, const std::vector<DBID>& dbids, 
+	const std::vector<MemoryStream*>& streams, std::vector<bool>& results, ScriptDefModule* pModule)
+{
+	EntityTable* pTable = this->findTable(pModule->getName());
+	KBE_ASSERT(pTable != NULL);
+
+	pTable->writeTables(dbi, dbids, streams, results, pModule);
+}
+
 //-------------------------------------------------------------------------------------
 bool EntityTables::removeEntity(DBInterface* dbi, DBID dbid, ScriptDefModule* pModule)
 {
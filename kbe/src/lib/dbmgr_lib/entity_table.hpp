@@ -224,6 +224,12 @@ public:
 	*/
 	virtual DBID writeTable(DBInterface* dbi, DBID dbid, MemoryStream* s, ScriptDefModule* pModule);
 
+	/**
+		¶Ѵݿеentity resultsÿentityǷдɹ
+	*/
+	virtual void writeTables(DBInterface* dbi, const std::vector<DBID>& dbids, 
+		const std::vector<MemoryStream*>& streams, std::vector<bool>& results, ScriptDefModule* pModule);
+
 	/**
 		ݿɾentity
 	*/
@@ -280,6 +286,8 @@ public:
 		дentityݿ
 	*/
 	DBID writeEntity(DBInterface* dbi, DBID dbid, MemoryStream* s, ScriptDefModule* pModule);
+	void writeEntities(DBInterface* dbi, const std::vector<DBID>& dbids, 
+		const std::vector<MemoryStream*>& streams, std::vector<bool>& results, ScriptDefModule* pModule);
 
 	/**
 		ݿɾentity
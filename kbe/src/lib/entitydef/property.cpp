@@ -185,6 +185,24 @@ PropertyDescription* PropertyDescription::createDescription(ENTITY_PROPERTY_UID
 	return propertyDescription;
 }
 
+//-------------------------------------------------------------------------------------
+bool PropertyDescription::isMutableValue(void)const
+{
+	switch(dataType_->type())
+	{
+	case DATA_TYPE_DIGIT:
+	case DATA_TYPE_STRING:
+	case DATA_TYPE_UNICODE:
+	case DATA_TYPE_BLOB:
+	case DATA_TYPE_MAILBOX:
+		return false;
+	default:
+		break;
+	};
+
+	return true;
+}
+
 //-------------------------------------------------------------------------------------
 PyObject* PropertyDescription::newDefaultVal(void)
 {
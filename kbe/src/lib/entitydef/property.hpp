@@ -118,6 +118,12 @@ public:
 	INLINE void setDatabaseLength(uint32 databaseLength);
 	INLINE uint32 getDatabaseLength()const;
 
+	/** 
+		ԵֵǷԱԭ޸(бappendֵ丳ֵ)
+		ԭ޸ĲᾭԸֵ ޷ͨonDefDataChanged֪Ƿ񱻸ı
+	*/
+	bool isMutableValue(void)const;
+
 	/** 
 		ȡdefļбĬֵ 
 	*/
@@ -33,7 +33,7 @@ namespace KBEngine {
 //-------------------------------------------------------------------------------------
 int32 watchBundlePool_size()
 {
-	return (int)Mercury::Bundle::ObjPool().objects().size();
+	return (int)Mercury::Bundle::ObjPool().size();
 }
 
 int32 watchBundlePool_max()
@@ -53,21 +53,28 @@ bool watchBundlePool_isDestroyed()
 
 uint32 watchBundlePool_bytes()
 {
-	size_t bytes = 0;
+	return (uint32)Mercury::Bundle::ObjPool().bytes();
+}
 
-	ObjectPool<Mercury::Bundle>::OBJECTS::const_iterator iter = Mercury::Bundle::ObjPool().objects().begin();
-	for(; iter != Mercury::Bundle::ObjPool().objects().end(); iter++)
-	{
-		bytes += static_cast<PoolObject*>((*iter))->getPoolObjectBytes();
-	}
+uint32 watchBundlePool_hits()
+{
+	return (uint32)Mercury::Bundle::ObjPool().hits();
+}
 
-	return (uint32)bytes;
+uint32 watchBundlePool_misses()
+{
+	return (uint32)Mercury::Bundle::ObjPool().misses();
+}
+
+uint32 watchBundlePool_peakAlloc()
+{
+	return (uint32)Mercury::Bundle::ObjPool().peakAlloc();
 }
 
 //-------------------------------------------------------------------------------------
 int32 watchAddressPool_size()
 {
-	return (int)Mercury::Address::ObjPool().objects().size();
+	return (int)Mercury::Address::ObjPool().size();
 }
 
 int32 watchAddressPool_max()
@@ -87,21 +94,28 @@ bool watchAddressPool_isDestroyed()
 
 uint32 watchAddressPool_bytes()
 {
-	size_t bytes = 0;
+	return (uint32)Mercury::Address::ObjPool().bytes();
+}
 
-	ObjectPool<Mercury::Address>::OBJECTS::const_iterator iter = Mercury::Address::ObjPool().objects().begin();
-	for(; iter != Mercury::Address::ObjPool().objects().end(); iter++)
-	{
-		bytes += static_cast<PoolObject*>((*iter))->getPoolObjectBytes();
-	}
+uint32 watchAddressPool_hits()
+{
+	return (uint32)Mercury::Address::ObjPool().hits();
+}
 
-	return (uint32)bytes;
+uint32 watchAddressPool_misses()
+{
+	return (uint32)Mercury::Address::ObjPool().misses();
+}
+
+uint32 watchAddressPool_peakAlloc()
+{
+	return (uint32)Mercury::Address::ObjPool().peakAlloc();
 }
 
 //-------------------------------------------------------------------------------------
 int32 watchMemoryStreamPool_size()
 {
-	return (int)MemoryStream::ObjPool().objects().size();
+	return (int)MemoryStream::ObjPool().size();
 }
 
 int32 watchMemoryStreamPool_max()
@@ -121,21 +135,28 @@ bool watchMemoryStreamPool_isDestroyed()
 
 uint32 watchMemoryStreamPool_bytes()
 {
-	size_t bytes = 0;
+	return (uint32)MemoryStream::ObjPool().bytes();
+}
 
-	ObjectPool<MemoryStream>::OBJECTS::const_iterator iter = MemoryStream::ObjPool().objects().begin();
-	for(; iter != MemoryStream::ObjPool().objects().end(); iter++)
-	{
-		bytes += static_cast<PoolObject*>((*iter))->getPoolObjectBytes();
-	}
+uint32 watchMemoryStreamPool_hits()
+{
+	return (uint32)MemoryStream::ObjPool().hits();
+}
 
-	return (uint32)bytes;
+uint32 watchMemoryStreamPool_misses()
+{
+	return (uint32)MemoryStream::ObjPool().misses();
+}
+
+uint32 watchMemoryStreamPool_peakAlloc()
+{
+	return (uint32)MemoryStream::ObjPool().peakAlloc();
 }
 
 //-------------------------------------------------------------------------------------
 int32 watchTCPPacketPool_size()
 {
-	return (int)Mercury::TCPPacket::ObjPool().objects().size();
+	return (int)Mercury::TCPPacket::ObjPool().size();
 }
 
 int32 watchTCPPacketPool_max()
@@ -155,21 +176,28 @@ bool watchTCPPacketPool_isDestroyed()
 
 uint32 watchTCPPacketPool_bytes()
 {
-	size_t bytes = 0;
+	return (uint32)Mercury::TCPPacket::ObjPool().bytes();
+}
 
-	ObjectPool<Mercury::TCPPacket>::OBJECTS::const_iterator iter = Mercury::TCPPacket::ObjPool().objects().begin();
-	for(; iter != Mercury::TCPPacket::ObjPool().objects().end(); iter++)
-	{
-		bytes += static_cast<PoolObject*>((*iter))->getPoolObjectBytes();
-	}
+uint32 watchTCPPacketPool_hits()
+{
+	return (uint32)Mercury::TCPPacket::ObjPool().hits();
+}
 
-	return (uint32)bytes;
+uint32 watchTCPPacketPool_misses()
+{
+	return (uint32)Mercury::TCPPacket::ObjPool().misses();
+}
+
+uint32 watchTCPPacketPool_peakAlloc()
+{
+	return (uint32)Mercury::TCPPacket::ObjPool().peakAlloc();
 }
 
 //-------------------------------------------------------------------------------------
 int32 watchTCPPacketReceiverPool_size()
 {
-	return (int)Mercury::TCPPacketReceiver::ObjPool().objects().size();
+	return (int)Mercury::TCPPacketReceiver::ObjPool().size();
 }
 
 int32 watchTCPPacketReceiverPool_max()
@@ -189,21 +217,28 @@ bool watchTCPPacketReceiverPool_isDestroyed()
 
 uint32 watchTCPPacketReceiverPool_bytes()
 {
-	size_t bytes = 0;
+	return (uint32)Mercury::TCPPacketReceiver::ObjPool().bytes();
+}
 
-	ObjectPool<Mercury::TCPPacketReceiver>::OBJECTS::const_iterator iter = Mercury::TCPPacketReceiver::ObjPool().objects().begin();
-	for(; iter != Mercury::TCPPacketReceiver::ObjPool().objects().end(); iter++)
-	{
-		bytes += static_cast<PoolObject*>((*iter))->getPoolObjectBytes();
-	}
+uint32 watchTCPPacketReceiverPool_hits()
+{
+	return (uint32)Mercury::TCPPacketReceiver::ObjPool().hits();
+}
 
-	return (uint32)bytes;
+uint32 watchTCPPacketReceiverPool_misses()
+{
+	return (uint32)Mercury::TCPPacketReceiver::ObjPool().misses();
+}
+
+uint32 watchTCPPacketReceiverPool_peakAlloc()
+{
+	return (uint32)Mercury::TCPPacketReceiver::ObjPool().peakAlloc();
 }
 
 //-------------------------------------------------------------------------------------
 int32 watchUDPPacketPool_size()
 {
-	return (int)Mercury::UDPPacket::ObjPool().objects().size();
+	return (int)Mercury::UDPPacket::ObjPool().size();
 }
 
 int32 watchUDPPacketPool_max()
@@ -223,21 +258,28 @@ bool watchUDPPacketPool_isDestroyed()
 
 uint32 watchUDPPacketPool_bytes()
 {
-	size_t bytes = 0;
+	return (uint32)Mercury::UDPPacket::ObjPool().bytes();
+}
 
-	ObjectPool<Mercury::UDPPacket>::OBJECTS::const_iterator iter = Mercury::UDPPacket::ObjPool().objects().begin();
-	for(; iter != Mercury::UDPPacket::ObjPool().objects().end(); iter++)
-	{
-		bytes += static_cast<PoolObject*>((*iter))->getPoolObjectBytes();
-	}
+uint32 watchUDPPacketPool_hits()
+{
+	return (uint32)Mercury::UDPPacket::ObjPool().hits();
+}
 
-	return (uint32)bytes;
+uint32 watchUDPPacketPool_misses()
+{
+	return (uint32)Mercury::UDPPacket::ObjPool().misses();
+}
+
+uint32 watchUDPPacketPool_peakAlloc()
+{
+	return (uint32)Mercury::UDPPacket::ObjPool().peakAlloc();
 }
 
 //-------------------------------------------------------------------------------------
 int32 watchUDPPacketReceiverPool_size()
 {
-	return (int)Mercury::UDPPacketReceiver::ObjPool().objects().size();
+	return (int)Mercury::UDPPacketReceiver::ObjPool().size();
 }
 
 int32 watchUDPPacketReceiverPool_max()
@@ -257,21 +299,28 @@ bool watchUDPPacketReceiverPool_isDestroyed()
 
 uint32 watchUDPPacketReceiverPool_bytes()
 {
-	size_t bytes = 0;
+	return (uint32)Mercury::UDPPacketReceiver::ObjPool().bytes();
+}
 
-	ObjectPool<Mercury::UDPPacketReceiver>::OBJECTS::const_iterator iter = Mercury::UDPPacketReceiver::ObjPool().objects().begin();
-	for(; iter != Mercury::UDPPacketReceiver::ObjPool().objects().end(); iter++)
-	{
-		bytes += static_cast<PoolObject*>((*iter))->getPoolObjectBytes();
-	}
+uint32 watchUDPPacketReceiverPool_hits()
+{
+	return (uint32)Mercury::UDPPacketReceiver::ObjPool().hits();
+}
 
-	return (uint32)bytes;
+uint32 watchUDPPacketReceiverPool_misses()
+{
+	return (uint32)Mercury::UDPPacketReceiver::ObjPool().misses();
+}
+
+uint32 watchUDPPacketReceiverPool_peakAlloc()
+{
+	return (uint32)Mercury::UDPPacketReceiver::ObjPool().peakAlloc();
 }
 
 //-------------------------------------------------------------------------------------
 int32 watchEndPointPool_size()
 {
-	return (int)Mercury::EndPoint::ObjPool().objects().size();
+	return (int)Mercury::EndPoint::ObjPool().size();
 }
 
 int32 watchEndPointPool_max()
@@ -291,15 +340,22 @@ bool watchEndPointPool_isDestroyed()
 
 uint32 watchEndPointPool_bytes()
 {
-	size_t bytes = 0;
+	return (uint32)Mercury::EndPoint::ObjPool().bytes();
+}
 
-	ObjectPool<Mercury::EndPoint>::OBJECTS::const_iterator iter = Mercury::EndPoint::ObjPool().objects().begin();
-	for(; iter != Mercury::EndPoint::ObjPool().objects().end(); iter++)
-	{
-		bytes += static_cast<PoolObject*>((*iter))->getPoolObjectBytes();
-	}
+uint32 watchEndPointPool_hits()
+{
+	return (uint32)Mercury::EndPoint::ObjPool().hits();
+}
 
-	return (uint32)bytes;
+uint32 watchEndPointPool_misses()
+{
+	return (uint32)Mercury::EndPoint::ObjPool().misses();
+}
+
+uint32 watchEndPointPool_peakAlloc()
+{
+	return (uint32)Mercury::EndPoint::ObjPool().peakAlloc();
 }
 
 //-------------------------------------------------------------------------------------
@@ -310,48 +366,72 @@ bool WatchPool::initWatchPools()
 	WATCH_OBJECT("objectPools/Bundle/isDestroyed", &watchBundlePool_isDestroyed);
 	WATCH_OBJECT("objectPools/Bundle/memory", &watchBundlePool_bytes);
 	WATCH_OBJECT("objectPools/Bundle/totalAllocs", &watchBundlePool_totalAlloc);
+	WATCH_OBJECT("objectPools/Bundle/hits", &watchBundlePool_hits);
+	WATCH_OBJECT("objectPools/Bundle/misses", &watchBundlePool_misses);
+	WATCH_OBJECT("objectPools/Bundle/peakAlloc", &watchBundlePool_peakAlloc);
 
 	WATCH_OBJECT("objectPools/Address/size", &watchAddressPool_size);
 	WATCH_OBJECT("objectPools/Address/max", &watchAddressPool_max);
 	WATCH_OBJECT("objectPools/Address/isDestroyed", &watchAddressPool_isDestroyed);
 	WATCH_OBJECT("objectPools/Address/memory", &watchAddressPool_bytes);
 	WATCH_OBJECT("objectPools/Address/totalAllocs", &watchAddressPool_totalAlloc);
+	WATCH_OBJECT("objectPools/Address/hits", &watchAddressPool_hits);
+	WATCH_OBJECT("objectPools/Address/misses", &watchAddressPool_misses);
+	WATCH_OBJECT("objectPools/Address/peakAlloc", &watchAddressPool_peakAlloc);
 
 	WATCH_OBJECT("objectPools/MemoryStream/size", &watchMemoryStreamPool_size);
 	WATCH_OBJECT("objectPools/MemoryStream/max", &watchMemoryStreamPool_max);
 	WATCH_OBJECT("objectPools/MemoryStream/isDestroyed", &watchMemoryStreamPool_isDestroyed);
 	WATCH_OBJECT("objectPools/MemoryStream/memory", &watchMemoryStreamPool_bytes);
 	WATCH_OBJECT("objectPools/MemoryStream/totalAllocs", &watchMemoryStreamPool_totalAlloc);
+	WATCH_OBJECT("objectPools/MemoryStream/hits", &watchMemoryStreamPool_hits);
+	WATCH_OBJECT("objectPools/MemoryStream/misses", &watchMemoryStreamPool_misses);
+	WATCH_OBJECT("objectPools/MemoryStream/peakAlloc", &watchMemoryStreamPool_peakAlloc);
 
 	WATCH_OBJECT("objectPools/TCPPacket/size", &watchTCPPacketPool_size);
 	WATCH_OBJECT("objectPools/TCPPacket/max", &watchTCPPacketPool_max);
 	WATCH_OBJECT("objectPools/TCPPacket/isDestroyed", &watchTCPPacketPool_isDestroyed);
 	WATCH_OBJECT("objectPools/TCPPacket/memory", &watchTCPPacketPool_bytes);
 	WATCH_OBJECT("objectPools/TCPPacket/totalAllocs", &watchTCPPacketPool_totalAlloc);
+	WATCH_OBJECT("objectPools/TCPPacket/hits", &watchTCPPacketPool_hits);
+	WATCH_OBJECT("objectPools/TCPPacket/misses", &watchTCPPacketPool_misses);
+	WATCH_OBJECT("objectPools/TCPPacket/peakAlloc", &watchTCPPacketPool_peakAlloc);
 
 	WATCH_OBJECT("objectPools/TCPPacketReceiver/size", &watchTCPPacketReceiverPool_size);
 	WATCH_OBJECT("objectPools/TCPPacketReceiver/max", &watchTCPPacketReceiverPool_max);
 	WATCH_OBJECT("objectPools/TCPPacketReceiver/isDestroyed", &watchTCPPacketReceiverPool_isDestroyed);
 	WATCH_OBJECT("objectPools/TCPPacketReceiver/memory", &watchTCPPacketReceiverPool_bytes);
 	WATCH_OBJECT("objectPools/TCPPacketReceiver/totalAllocs", &watchTCPPacketReceiverPool_totalAlloc);
+	WATCH_OBJECT("objectPools/TCPPacketReceiver/hits", &watchTCPPacketReceiverPool_hits);
+	WATCH_OBJECT("objectPools/TCPPacketReceiver/misses", &watchTCPPacketReceiverPool_misses);
+	WATCH_OBJECT("objectPools/TCPPacketReceiver/peakAlloc", &watchTCPPacketReceiverPool_peakAlloc);
 
 	WATCH_OBJECT("objectPools/UDPPacket/size", &watchUDPPacketPool_size);
 	WATCH_OBJECT("objectPools/UDPPacket/max", &watchUDPPacketPool_max);
 	WATCH_OBJECT("objectPools/UDPPacket/isDestroyed", &watchUDPPacketPool_isDestroyed);
 	WATCH_OBJECT("objectPools/UDPPacket/memory", &watchUDPPacketPool_bytes);
 	WATCH_OBJECT("objectPools/UDPPacket/totalAllocs", &watchUDPPacketPool_totalAlloc);
+	WATCH_OBJECT("objectPools/UDPPacket/hits", &watchUDPPacketPool_hits);
+	WATCH_OBJECT("objectPools/UDPPacket/misses", &watchUDPPacketPool_misses);
+	WATCH_OBJECT("objectPools/UDPPacket/peakAlloc", &watchUDPPacketPool_peakAlloc);
 
 	WATCH_OBJECT("objectPools/UDPPacketReceiver/size", &watchUDPPacketReceiverPool_size);
 	WATCH_OBJECT("objectPools/UDPPacketReceiver/max", &watchUDPPacketReceiverPool_max);
 	WATCH_OBJECT("objectPools/UDPPacketReceiver/isDestroyed", &watchUDPPacketReceiverPool_isDestroyed);
 	WATCH_OBJECT("objectPools/UDPPacketReceiver/memory", &watchUDPPacketReceiverPool_bytes);
 	WATCH_OBJECT("objectPools/UDPPacketReceiver/totalAllocs", &watchUDPPacketReceiverPool_totalAlloc);
+	WATCH_OBJECT("objectPools/UDPPacketReceiver/hits", &watchUDPPacketReceiverPool_hits);
+	WATCH_OBJECT("objectPools/UDPPacketReceiver/misses", &watchUDPPacketReceiverPool_misses);
+	WATCH_OBJECT("objectPools/UDPPacketReceiver/peakAlloc", &watchUDPPacketReceiverPool_peakAlloc);
 
 	WATCH_OBJECT("objectPools/EndPoint/size", &watchEndPointPool_size);
 	WATCH_OBJECT("objectPools/EndPoint/max", &watchEndPointPool_max);
 	WATCH_OBJECT("objectPools/EndPoint/isDestroyed", &watchEndPointPool_isDestroyed);
 	WATCH_OBJECT("objectPools/EndPoint/memory", &watchEndPointPool_bytes);
 	WATCH_OBJECT("objectPools/EndPoint/totalAllocs", &watchEndPointPool_totalAlloc);
+	WATCH_OBJECT("objectPools/EndPoint/hits", &watchEndPointPool_hits);
+	WATCH_OBJECT("objectPools/EndPoint/misses", &watchEndPointPool_misses);
+	WATCH_OBJECT("objectPools/EndPoint/peakAlloc", &watchEndPointPool_peakAlloc);
 	return true;
 }
 
@@ -97,6 +97,22 @@ inline bool operator<(const Address & a, const Address & b)
 	return (a.ip < b.ip) || (a.ip == b.ip && (a.port < b.port));
 }
 
+/**
+	ip:portΪhash ԵַΪhashʹ
+	ͬһεipĶ˿ڣ ｫϺʹ
+*/
+struct AddressHash
+{
+	size_t operator()(const Address & addr) const
+	{
+		uint64 k = ((uint64)addr.ip << 16) | addr.port;
+		k ^= k >> 33;
+		k *= 0xff51afd7ed558ccdULL;
+		k ^= k >> 33;
+		return (size_t)k;
+	}
+};
+
 
 }
 }
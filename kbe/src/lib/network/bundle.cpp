@@ -34,6 +34,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 #ifdef USE_OPENSSL
 #include "cstdkbe/blowfish.hpp"
+#include "cstdkbe/chacha20poly1305.hpp"
 #endif
 
 #define BUNDLE_SEND_OP(op)																					\
@@ -118,7 +119,7 @@ void Bundle::destroyObjPool()
 //-------------------------------------------------------------------------------------
 size_t Bundle::getPoolObjectBytes()
 {
-	size_t bytes = sizeof(reuse_) + sizeof(pCurrMsgHandler_) + sizeof(isTCPPacket_) + 
+	size_t bytes = sizeof(reuse_) + sizeof(reliable_) + sizeof(pCurrMsgHandler_) + sizeof(isTCPPacket_) + 
 		sizeof(currMsgLengthPos_) + sizeof(currMsgHandlerLength_) + sizeof(currMsgLength_) + 
 		sizeof(currMsgPacketCount_) + sizeof(currMsgID_) + sizeof(numMessages_) + sizeof(pChannel_)
 		+ (packets_.size() * sizeof(Packet*));
@@ -145,7 +146,8 @@ Bundle::Bundle(Channel * pChannel, ProtocolType pt):
 	packets_(),
 	isTCPPacket_(pt == PROTOCOL_TCP),
 	pCurrMsgHandler_(NULL),
-	reuse_(false)
+	reuse_(false),
+	reliable_(true)
 {
 	 newPacket();
 }
@@ -180,13 +182,8 @@ int32 Bundle::packetsLength(bool calccurr)
 }
 
 //-------------------------------------------------------------------------------------
-int32 Bundle::onPacketAppend(int32 addsize, bool inseparable)
+int32 Bundle::packetMaxSize() const
 {
-	if(pCurrPacket_ == NULL)
-	{
-		newPacket();
-	}
-
 	int32 packetmaxsize = PACKET_MAX_CHUNK_SIZE();
 
 #ifdef USE_OPENSSL
@@ -194,8 +191,25 @@ int32 Bundle::onPacketAppend(int32 addsize, bool inseparable)
 	// ڼһذʱҪֽ
 	if(g_channelExternalEncryptType == 1)
 		packetmaxsize -=  packetmaxsize % KBEngine::KBEBlowfish::BLOCK_SIZE;
+
+	// AEADҪ䣬 ÿӵtagBlowfish
+	else if(g_channelExternalEncryptType == 3)
+		packetmaxsize -= KBEngine::KBEChaCha20Poly1305::TAG_SIZE - ENCRYPTTION_WASTAGE_SIZE;
 #endif
 
+	return packetmaxsize;
+}
+
+//-------------------------------------------------------------------------------------
+int32 Bundle::onPacketAppend(int32 addsize, bool inseparable)
+{
+	if(pCurrPacket_ == NULL)
+	{
+		newPacket();
+	}
+
+	int32 packetmaxsize = packetMaxSize();
+
 	int32 totalsize = (int32)pCurrPacket_->totalSize();
 	int32 fwpos = (int32)pCurrPacket_->wpos();
 
@@ -314,6 +328,7 @@ void Bundle::clear(bool isRecl)
 	packets_.clear();
 
 	reuse_ = false;
+	reliable_ = true;
 	pChannel_ = NULL;
 	numMessages_ = 0;
 
@@ -39,7 +39,7 @@ class NetworkInterface;
 class Channel;
 
 #define PACKET_MAX_CHUNK_SIZE() isTCPPacket_ ? (PACKET_MAX_SIZE_TCP - ENCRYPTTION_WASTAGE_SIZE):			\
-	(PACKET_MAX_SIZE_UDP - ENCRYPTTION_WASTAGE_SIZE);
+	(PACKET_MAX_SIZE_UDP - ENCRYPTTION_WASTAGE_SIZE - RELIABLE_UDP_HEADER_SIZE);
 
 #define PACKET_OUT_VALUE(v)																					\
 	if(packets_.size() <= 0)																				\
@@ -130,6 +130,11 @@ public:
 	void sendto(EndPoint& ep, u_int16_t networkPort, u_int32_t networkAddr = BROADCAST);
 	void onSendCompleted();
 	
+	Channel* pChannel() const { return pChannel_; }
+	void pChannel(Channel* p) { pChannel_ = p; }
+
+	bool isTCPPacket() const { return isTCPPacket_; }
+
 	void clearPackets(){packets_.clear();}
 
 	MessageLength currMsgLength()const { return currMsgLength_; }
@@ -161,6 +166,16 @@ public:
 
 	bool reuse(){ return reuse_; } 
 	void setreuse(bool v = true){ reuse_ = v; } 
+
+	/**
+		ΪfalseʱڿɿUDP߲ͨɿͨ(ʧش ڶ) ͨ
+	*/
+	bool reliable() const { return reliable_; }
+	void reliable(bool v){ reliable_ = v; }
+	/**
+		һװصݳ
+	*/
+	int32 packetMaxSize() const;
 public:
 	int32 onPacketAppend(int32 addsize, bool inseparable = true);
 
@@ -451,6 +466,8 @@ private:
 
 	bool reuse_;
 
+	bool reliable_;
+
 };
 
 }
@@ -90,7 +90,9 @@ Channel::Channel(NetworkInterface & networkInterface,
 	strextra_(),
 	channelType_(CHANNEL_NORMAL),
 	componentID_(UNKNOWN_COMPONENT_TYPE),
-	pMsgHandlers_(NULL)
+	pMsgHandlers_(NULL),
+	inActiveList_(false),
+	inReapList_(false)
 {
 	this->incRef();
 	this->clearBundle();
@@ -100,7 +102,7 @@ Channel::Channel(NetworkInterface & networkInterface,
 	{
 		pPacketReceiver_ = new TCPPacketReceiver(*pEndPoint_, networkInterface);
 		// UDPҪע
-		pNetworkInterface_->dispatcher().registerFileDescriptor(*pEndPoint_, pPacketReceiver_);
+		pNetworkInterface_->dispatcher().registerFileDescriptor(*pEndPoint_, pPacketReceiver_, g_pollerEdgeTriggered);
 	}
 	else
 		pPacketReceiver_ = new UDPPacketReceiver(*pEndPoint_, networkInterface);
@@ -136,7 +138,9 @@ Channel::Channel():
 	strextra_(),
 	channelType_(CHANNEL_NORMAL),
 	componentID_(UNKNOWN_COMPONENT_TYPE),
-	pMsgHandlers_(NULL)
+	pMsgHandlers_(NULL),
+	inActiveList_(false),
+	inReapList_(false)
 {
 	this->incRef();
 	this->clearBundle();
@@ -227,6 +231,9 @@ void Channel::destroy()
 	{
 		pNetworkInterface_->onChannelGone(this);
 
+		// ʱȻעNetworkInterfaceУ ɻбһδʱע
+		pNetworkInterface_->onChannelCondemn(this);
+
 		if(protocoltype_ == PROTOCOL_TCP)
 		{
 			pNetworkInterface_->dispatcher().deregisterFileDescriptor(*pEndPoint_);
@@ -344,11 +351,12 @@ void Channel::send(Bundle * pBundle)
 	if(bundles_.size() == 0)
 		return;
 
+	// bundleİۺϺһϵͳ÷
+	pNetworkInterface_->sendBundles(bundles_, this);
+
 	Bundles::iterator iter = bundles_.begin();
 	for(; iter != bundles_.end(); iter++)
 	{
-		(*iter)->send(*pNetworkInterface_, this);
-
 		++numPacketsSent_;
 		++g_numPacketsSent;
 		numBytesSent_ += (*iter)->totalSize();
@@ -437,6 +445,10 @@ void Channel::onPacketReceived(int bytes)
 	lastTickBytesReceived_ += bytes;
 	g_numBytesReceived += bytes;
 
+	// յݣ tickҪͨ(ͬʱlastTickBytesReceived_)
+	if(pNetworkInterface_ != NULL)
+		pNetworkInterface_->onChannelActive(this);
+
 	if(this->isExternal())
 	{
 		if(g_extReceiveWindowBytesOverflow > 0 && 
@@ -464,6 +476,9 @@ void Channel::addReceiveWindow(Packet* pPacket)
 {
 	bufferedReceives_[bufferedReceivesIdx_].push_back(pPacket);
 
+	if(pNetworkInterface_ != NULL)
+		pNetworkInterface_->onChannelActive(this);
+
 	if(Mercury::g_receiveWindowMessagesOverflowCritical > 0 && bufferedReceives_[bufferedReceivesIdx_].size() > Mercury::g_receiveWindowMessagesOverflowCritical)
 	{
 		if(this->isExternal())
@@ -497,6 +512,9 @@ void Channel::condemn()
 { 
 	isCondemn_ = true; 
 	ERROR_MSG(boost::format("Channel::condemn[%1%]: channel(%2%).\n") % this % this->c_str()); 
+
+	if(pNetworkInterface_ != NULL && pEndPoint_ != NULL)
+		pNetworkInterface_->onChannelCondemn(this);
 }
 
 //-------------------------------------------------------------------------------------
@@ -140,8 +140,11 @@ public:
 	void reset(const EndPoint* endpoint, bool warnOnDiscard = true);
 
 	Traits traits() const { return traits_; }
+	ProtocolType protocoltype() const { return protocoltype_; }
 	bool isExternal() const { return traits_ == EXTERNAL; }
 	bool isInternal() const { return traits_ == INTERNAL; }
+
+	ChannelTypes channelType() const { return channelType_; }
 		
 	void onPacketReceived(int bytes);
 	
@@ -168,6 +171,14 @@ public:
 	bool isCondemn()const { return isCondemn_; }
 	void condemn();
 
+	/**
+		ǷNetworkInterfaceĴͨбͨб
+	*/
+	bool inActiveList()const { return inActiveList_; }
+	void inActiveList(bool v){ inActiveList_ = v; }
+	bool inReapList()const { return inReapList_; }
+	void inReapList(bool v){ inReapList_ = v; }
+
 	ENTITY_ID proxyID()const { return proxyID_; }
 	void proxyID(ENTITY_ID pid){ proxyID_ = pid; }
 
@@ -246,6 +257,9 @@ private:
 
 	// ָ֧ĳͨʹĳϢhandlers
 	KBEngine::Mercury::MessageHandlers* pMsgHandlers_;
+
+	bool						inActiveList_;
+	bool						inReapList_;
 };
 
 typedef SmartPointer<Channel> ChannelPtr;
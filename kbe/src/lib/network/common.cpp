@@ -53,6 +53,14 @@ uint32						g_extReceiveWindowMessagesOverflow = 256;
 uint32						g_intReceiveWindowBytesOverflow = 0;
 uint32						g_extReceiveWindowBytesOverflow = 65535;
 
+uint32						g_intReceivePacketsLimit = 0;
+uint32						g_extReceivePacketsLimit = 16;
+
+uint32						g_pollerMaxEvents = 256;
+bool						g_pollerEdgeTriggered = false;
+
+bool						g_extReliableUDP = false;
+
 // ͨͳʱ
 uint32						g_intReSendInterval = 10;
 uint32						g_intReSendRetries = 0;
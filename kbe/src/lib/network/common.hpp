@@ -74,6 +74,9 @@ namespace tcp{
 // ܶ洢Ϣռֽ(+)
 #define ENCRYPTTION_WASTAGE_SIZE			(1 + 7)
 
+// ɿUDPÿݱǰӵͷ(cmd, flags, sn, una, ackMask, wnd, rsn)
+#define RELIABLE_UDP_HEADER_SIZE			(1 + 1 + 4 + 4 + 4 + 2 + 4)
+
 #define PACKET_MAX_SIZE						1500
 #define PACKET_MAX_SIZE_TCP					1460
 #define PACKET_MAX_SIZE_UDP					1472
@@ -236,6 +239,17 @@ extern uint32						g_extReceiveWindowMessagesOverflow;
 extern uint32						g_intReceiveWindowBytesOverflow;
 extern uint32						g_extReceiveWindowBytesOverflow;
 
+// һοɶ֪ͨڵͨsocketȡİ
+extern uint32						g_intReceivePacketsLimit;
+extern uint32						g_extReceivePacketsLimit;
+
+// epoll_waitһ෵ص¼ ͨsocketǷʹñԵ
+extern uint32						g_pollerMaxEvents;
+extern bool							g_pollerEdgeTriggered;
+
+// ⲿUDPͨǷʹÿɿUDP
+extern bool							g_extReliableUDP;
+
 bool initializeWatcher();
 void finalise(void);
 
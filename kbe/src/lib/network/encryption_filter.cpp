@@ -328,6 +328,261 @@ void BlowfishFilter::decrypt(Packet * pInPacket, Packet * pOutPacket)
 	}
 }
 
+//-------------------------------------------------------------------------------------
+ChaCha20Poly1305Filter::ChaCha20Poly1305Filter(const Key & key):
+KBEChaCha20Poly1305(key),
+pPacket_(NULL),
+packetLen_(0),
+sendDirection_(1),
+recvDirection_(0),
+sendCounter_(0),
+recvCounter_(0)
+{
+	memset(packetLenData_, 0, sizeof(packetLenData_));
+}
+
+//-------------------------------------------------------------------------------------
+ChaCha20Poly1305Filter::ChaCha20Poly1305Filter():
+KBEChaCha20Poly1305(),
+pPacket_(NULL),
+packetLen_(0),
+sendDirection_(0),
+recvDirection_(1),
+sendCounter_(0),
+recvCounter_(0)
+{
+	memset(packetLenData_, 0, sizeof(packetLenData_));
+}
+
+//-------------------------------------------------------------------------------------
+ChaCha20Poly1305Filter::~ChaCha20Poly1305Filter()
+{
+	if(pPacket_)
+	{
+		reclaimPacket(pPacket_);
+		pPacket_ = NULL;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void ChaCha20Poly1305Filter::reclaimPacket(Packet * pPacket)
+{
+	if(pPacket->isTCPPacket())
+		TCPPacket::ObjPool().reclaimObject(static_cast<TCPPacket *>(pPacket));
+	else
+		UDPPacket::ObjPool().reclaimObject(static_cast<UDPPacket *>(pPacket));
+}
+
+//-------------------------------------------------------------------------------------
+void ChaCha20Poly1305Filter::makeNonce(uint8 * nonce, uint32 direction, uint64 counter) const
+{
+	for(int i = 0; i < 4; ++i)
+		nonce[i] = (uint8)(direction >> (i * 8));
+
+	for(int i = 0; i < 8; ++i)
+		nonce[4 + i] = (uint8)(counter >> (i * 8));
+}
+
+//-------------------------------------------------------------------------------------
+Reason ChaCha20Poly1305Filter::send(NetworkInterface & networkInterface, Channel * pChannel, Packet * pPacket)
+{
+	if(!pPacket->encrypted())
+	{
+		AUTO_SCOPED_PROFILE("encryptSend")
+		
+		if (!isGood_)
+		{
+			WARNING_MSG(boost::format("ChaCha20Poly1305Filter::send: "
+				"Dropping packet to %1% due to invalid filter\n") %
+				pChannel->addr().c_str() );
+
+			return REASON_GENERAL_NETWORK;
+		}
+
+		Packet * pOutPacket = NULL;
+		if(pPacket->isTCPPacket())
+			pOutPacket = TCPPacket::ObjPool().createObject();
+		else
+			pOutPacket = UDPPacket::ObjPool().createObject();
+
+		// ֱд° ҪĿ
+		encrypt(pPacket, pOutPacket);
+
+		pPacket->swap(*(static_cast<KBEngine::MemoryStream*>(pOutPacket)));
+		pPacket->encrypted(true);
+		reclaimPacket(pOutPacket);
+	}
+
+	return networkInterface.basicSendWithRetries(pChannel, pPacket);
+}
+
+//-------------------------------------------------------------------------------------
+Reason ChaCha20Poly1305Filter::recv(Channel * pChannel, PacketReceiver & receiver, Packet * pPacket)
+{
+	while(pPacket || pPacket_)
+	{
+		AUTO_SCOPED_PROFILE("encryptRecv")
+
+		if (!isGood_)
+		{
+			WARNING_MSG(boost::format("ChaCha20Poly1305Filter::recv: "
+				"Dropping packet to %1% due to invalid filter\n") %
+				pChannel->addr().c_str() );
+
+			return REASON_GENERAL_NETWORK;
+		}
+
+		if(pPacket_)
+		{
+			if(pPacket)
+			{
+				pPacket_->append(pPacket->data() + pPacket->rpos(), pPacket->opsize());
+				reclaimPacket(pPacket);
+			}
+
+			pPacket = pPacket_;
+			pPacket_ = NULL;
+		}
+
+		if(packetLen_ <= 0)
+		{
+			// ȲԶͷ һϲ
+			if(pPacket->opsize() < PACKET_LENGTH_SIZE)
+			{
+				pPacket_ = pPacket;
+				return receiver.processFilteredPacket(pChannel, NULL);
+			}
+
+			memcpy(packetLenData_, pPacket->data() + pPacket->rpos(), PACKET_LENGTH_SIZE);
+			(*pPacket) >> packetLen_;
+
+			if(packetLen_ < TAG_SIZE)
+			{
+				WARNING_MSG(boost::format("ChaCha20Poly1305Filter::recv: "
+					"invalid packetLen(%1%) from %2%\n") %
+					packetLen_ % pChannel->addr().c_str() );
+
+				packetLen_ = 0;
+				reclaimPacket(pPacket);
+				pChannel->condemn();
+				return REASON_CORRUPTED_PACKET;
+			}
+		}
+
+		//  ȴ
+		if(pPacket->opsize() < packetLen_)
+		{
+			pPacket_ = pPacket;
+			return receiver.processFilteredPacket(pChannel, NULL);
+		}
+
+		// һ óݺϲ
+		if(pPacket->opsize() > packetLen_)
+		{
+			if(pPacket->isTCPPacket())
+				pPacket_ = TCPPacket::ObjPool().createObject();
+			else
+				pPacket_ = UDPPacket::ObjPool().createObject();
+
+			pPacket_->append(pPacket->data() + pPacket->rpos() + packetLen_, pPacket->wpos() - (packetLen_ + pPacket->rpos()));
+			pPacket->wpos(pPacket->rpos() + packetLen_);
+		}
+
+		packetLen_ = 0;
+
+		if(!decryptPacket(pPacket))
+		{
+			WARNING_MSG(boost::format("ChaCha20Poly1305Filter::recv: "
+				"authentication failed, from %1%\n") %
+				pChannel->addr().c_str() );
+
+			reclaimPacket(pPacket);
+
+			if(pPacket_)
+			{
+				reclaimPacket(pPacket_);
+				pPacket_ = NULL;
+			}
+
+			pChannel->condemn();
+			return REASON_CORRUPTED_PACKET;
+		}
+
+		Reason ret = receiver.processFilteredPacket(pChannel, pPacket);
+		if(ret != REASON_SUCCESS)
+		{
+			if(pPacket_)
+			{
+				reclaimPacket(pPacket_);
+				pPacket_ = NULL;
+			}
+
+			return ret;
+		}
+
+		pPacket = NULL;
+	}
+
+	return REASON_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------
+void ChaCha20Poly1305Filter::encrypt(Packet * pInPacket, Packet * pOutPacket)
+{
+	KBE_ASSERT(pInPacket != pOutPacket);
+
+	PacketLength length = (PacketLength)pInPacket->opsize();
+	PacketLength packetLen = length + TAG_SIZE;
+
+	pOutPacket->wpos(0);
+	(*pOutPacket) << packetLen;
+
+	size_t totalSize = PACKET_LENGTH_SIZE + packetLen;
+	if(pOutPacket->size() < totalSize)
+		pOutPacket->data_resize(totalSize);
+
+	uint8 nonce[NONCE_SIZE];
+	makeNonce(nonce, sendDirection_, sendCounter_++);
+
+	uint8 * pData = pOutPacket->data();
+	seal(nonce, pData, PACKET_LENGTH_SIZE, pInPacket->data() + pInPacket->rpos(), 
+		pData + PACKET_LENGTH_SIZE, length, pData + PACKET_LENGTH_SIZE + length);
+
+	pOutPacket->wpos(totalSize);
+}
+
+//-------------------------------------------------------------------------------------
+void ChaCha20Poly1305Filter::decrypt(Packet * pInPacket, Packet * pOutPacket)
+{
+	KBE_ASSERT(pInPacket == pOutPacket);
+
+	if(!decryptPacket(pInPacket))
+	{
+		WARNING_MSG("ChaCha20Poly1305Filter::decrypt: authentication failed.\n");
+		pInPacket->opfini();
+	}
+}
+
+//-------------------------------------------------------------------------------------
+bool ChaCha20Poly1305Filter::decryptPacket(Packet * pPacket)
+{
+	// ǰֻʣtag ͷѾpacketLenData_
+	if(pPacket->opsize() < (size_t)TAG_SIZE)
+		return false;
+
+	uint32 length = pPacket->opsize() - TAG_SIZE;
+
+	uint8 nonce[NONCE_SIZE];
+	makeNonce(nonce, recvDirection_, recvCounter_++);
+
+	uint8 * pData = pPacket->data() + pPacket->rpos();
+	if(!open(nonce, packetLenData_, PACKET_LENGTH_SIZE, pData, pData, length, pData + length))
+		return false;
+
+	pPacket->wpos(pPacket->rpos() + length);
+	return true;
+}
+
 //-------------------------------------------------------------------------------------
 
 #endif
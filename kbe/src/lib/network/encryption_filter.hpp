@@ -26,6 +26,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 
 #ifdef USE_OPENSSL
 #include "cstdkbe/blowfish.hpp"
+#include "cstdkbe/chacha20poly1305.hpp"
 #endif
 
 namespace KBEngine { 
@@ -39,6 +40,9 @@ public:
 
 	virtual void encrypt(Packet * pInPacket, Packet * pOutPacket) = 0;
 	virtual void decrypt(Packet * pInPacket, Packet * pOutPacket) = 0;
+
+	// ʱͻ˷͸˵Կ
+	virtual const std::string & key() const = 0;
 };
 
 #ifdef USE_OPENSSL
@@ -57,28 +61,77 @@ public:
 
 	void encrypt(Packet * pInPacket, Packet * pOutPacket);
 	void decrypt(Packet * pInPacket, Packet * pOutPacket);
+
+	const Key & key() const { return KBEBlowfish::key(); }
 private:
 	Packet * pPacket_;
 	Mercury::PacketLength packetLen_;
 	uint8 padSize_;
 };
 
+/*
+	ChaCha20-Poly1305 AEAD
+	ÿװΪ: PacketLength len |  | tag(TAG_SIZE) lenΪtagĳȲΪ֤ݣ
+	Ҫ䣬 ۸Ļߴλİ֤ʱ֡
+	nonceɷÿļɣ 䣬 TCP֤˳
+	Կһ(ͻ)յԿһ()ʹòͬķ nonce
+*/
+class ChaCha20Poly1305Filter : public EncryptionFilter, public KBEChaCha20Poly1305
+{
+public:
+	virtual ~ChaCha20Poly1305Filter();
+
+	// ʹյԿ
+	ChaCha20Poly1305Filter(const Key & key);
+
+	// ͻԿ
+	ChaCha20Poly1305Filter();
+
+	virtual Reason send(NetworkInterface & networkInterface, Channel * pChannel, Packet * pPacket);
+
+	virtual Reason recv(Channel * pChannel, PacketReceiver & receiver, Packet * pPacket);
+
+	void encrypt(Packet * pInPacket, Packet * pOutPacket);
+	void decrypt(Packet * pInPacket, Packet * pOutPacket);
+
+	const Key & key() const { return KBEChaCha20Poly1305::key(); }
+private:
+	void makeNonce(uint8 * nonce, uint32 direction, uint64 counter) const;
+	bool decryptPacket(Packet * pPacket);
+	void reclaimPacket(Packet * pPacket);
+
+	Packet * pPacket_;
+	Mercury::PacketLength packetLen_;
+	uint8 packetLenData_[PACKET_LENGTH_SIZE];
+
+	uint32 sendDirection_;
+	uint32 recvDirection_;
+	uint64 sendCounter_;
+	uint64 recvCounter_;
+};
+
 #else
 
 class BlowfishFilter : public EncryptionFilter
 {
 public:
-	BlowfishFilter(const std::string & key){}
+	BlowfishFilter(const std::string & key):key_(key){}
 	BlowfishFilter(){}
 	virtual ~BlowfishFilter() {}
 	void encrypt(Packet * pInPacket, Packet * pOutPacket){}
 	void decrypt(Packet * pInPacket, Packet * pOutPacket){}
+	const std::string & key() const { return key_; }
+private:
+	std::string key_;
 };
 
 #endif
 
 typedef SmartPointer<BlowfishFilter> BlowfishFilterPtr;
 
+/**
+	ʹÿͻзԿ
+*/
 inline EncryptionFilter* createEncryptionFilter(int8 type, const std::string& datas)
 {
 	EncryptionFilter* pEncryptionFilter = NULL;
@@ -87,6 +140,34 @@ inline EncryptionFilter* createEncryptionFilter(int8 type, const std::string& da
 	case 1:
 		pEncryptionFilter = new BlowfishFilter(datas);
 		break;
+#ifdef USE_OPENSSL
+	case 3:
+		pEncryptionFilter = new ChaCha20Poly1305Filter(datas);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	return pEncryptionFilter;
+}
+
+/**
+	ͻԿ Կͨkey()з͸
+*/
+inline EncryptionFilter* createEncryptionFilter(int8 type)
+{
+	EncryptionFilter* pEncryptionFilter = NULL;
+	switch(type)
+	{
+	case 1:
+		pEncryptionFilter = new BlowfishFilter();
+		break;
+#ifdef USE_OPENSSL
+	case 3:
+		pEncryptionFilter = new ChaCha20Poly1305Filter();
+		break;
+#endif
 	default:
 		break;
 	}
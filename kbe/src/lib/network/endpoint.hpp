@@ -85,6 +85,25 @@ public:
 	
 	INLINE int send(const void * gramData, int gramSize);
 
+#ifdef unix
+	/**
+		ۺϷͣ һϵͳд(TCP)
+	*/
+	INLINE int sendv(const struct iovec * iov, int iovcnt);
+#endif
+
+#if defined(__linux__)
+	/**
+		ۺϷͣ һϵͳ÷ݱ(UDP) طݱ
+	*/
+	INLINE int sendmmsg(struct mmsghdr * msgs, unsigned int vlen);
+
+	/**
+		գ һϵͳȡݱ(UDP) յݱ
+	*/
+	INLINE int recvmmsg(struct mmsghdr * msgs, unsigned int vlen);
+#endif
+
 	int recv(void * gramData, int gramSize);
 	bool recvAll(void * gramData, int gramSize);
 	
@@ -418,6 +418,25 @@ INLINE int EndPoint::send(const void * gramData, int gramSize)
 	return ::send(socket_, (char*)gramData, gramSize, 0);
 }
 
+#ifdef unix
+INLINE int EndPoint::sendv(const struct iovec * iov, int iovcnt)
+{
+	return ::writev(socket_, iov, iovcnt);
+}
+#endif
+
+#if defined(__linux__)
+INLINE int EndPoint::sendmmsg(struct mmsghdr * msgs, unsigned int vlen)
+{
+	return ::sendmmsg(socket_, msgs, vlen, 0);
+}
+
+INLINE int EndPoint::recvmmsg(struct mmsghdr * msgs, unsigned int vlen)
+{
+	return ::recvmmsg(socket_, msgs, vlen, 0, NULL);
+}
+#endif
+
 INLINE int EndPoint::recv(void * gramData, int gramSize)
 {
 	return ::recv(socket_, (char*)gramData, gramSize, 0);
@@ -122,9 +122,9 @@ void EventDispatcher::detachFrom(EventDispatcher & parentDispatcher)
 
 //-------------------------------------------------------------------------------------
 bool EventDispatcher::registerFileDescriptor(int fd,
-	InputNotificationHandler * handler)
+	InputNotificationHandler * handler, bool edgeTriggered)
 {
-	return pPoller_->registerForRead(fd, handler);
+	return pPoller_->registerForRead(fd, handler, edgeTriggered);
 }
 
 //-------------------------------------------------------------------------------------
@@ -67,7 +67,7 @@ public:
 	INLINE double maxWait() const;
 	INLINE void maxWait(double seconds);
 
-	bool registerFileDescriptor(int fd, InputNotificationHandler * handler);
+	bool registerFileDescriptor(int fd, InputNotificationHandler * handler, bool edgeTriggered = false);
 	bool deregisterFileDescriptor(int fd);
 	bool registerWriteFileDescriptor(int fd, InputNotificationHandler * handler);
 	bool deregisterWriteFileDescriptor(int fd);
@@ -50,14 +50,14 @@ EventPoller::~EventPoller()
 
 //-------------------------------------------------------------------------------------
 bool EventPoller::registerForRead(int fd,
-		InputNotificationHandler * handler)
+		InputNotificationHandler * handler, bool edgeTriggered)
 {
-	if (!this->doRegisterForRead(fd))
+	if (!this->doRegisterForRead(fd, edgeTriggered))
 	{
 		return false;
 	}
 
-	fdReadHandlers_[ fd ] = handler;
+	EventPoller::setHandler(fdReadHandlers_, fd, handler);
 
 	return true;
 }
@@ -71,7 +71,7 @@ bool EventPoller::registerForWrite(int fd,
 		return false;
 	}
 
-	fdWriteHandlers_[ fd ] = handler;
+	EventPoller::setHandler(fdWriteHandlers_, fd, handler);
 
 	return true;
 }
@@ -79,7 +79,7 @@ bool EventPoller::registerForWrite(int fd,
 //-------------------------------------------------------------------------------------
 bool EventPoller::deregisterForRead(int fd)
 {
-	fdReadHandlers_.erase(fd);
+	EventPoller::setHandler(fdReadHandlers_, fd, NULL);
 
 	return this->doDeregisterForRead(fd);
 }
@@ -87,7 +87,7 @@ bool EventPoller::deregisterForRead(int fd)
 //-------------------------------------------------------------------------------------
 bool EventPoller::deregisterForWrite(int fd)
 {
-	fdWriteHandlers_.erase(fd);
+	EventPoller::setHandler(fdWriteHandlers_, fd, NULL);
 
 	return this->doDeregisterForWrite(fd);
 }
@@ -95,14 +95,14 @@ bool EventPoller::deregisterForWrite(int fd)
 //-------------------------------------------------------------------------------------
 bool EventPoller::trigger(int fd, FDHandlers & handlers)
 {
-	FDHandlers::iterator iter = handlers.find(fd);
+	InputNotificationHandler* pHandler = EventPoller::findHandler(handlers, fd);
 
-	if (iter == handlers.end())
+	if (pHandler == NULL)
 	{
 		return false;
 	}
 
-	iter->second->handleInputNotification(fd);
+	pHandler->handleInputNotification(fd);
 
 	return true;
 }
@@ -124,21 +124,58 @@ bool EventPoller::isRegistered(int fd, bool isForRead) const
 	const FDHandlers & handlers =
 		isForRead ? fdReadHandlers_ : fdWriteHandlers_;
 
-	return handlers.find(fd) != handlers.end();
+	return EventPoller::findHandler(handlers, fd) != NULL;
 }
 
 //-------------------------------------------------------------------------------------
 InputNotificationHandler* EventPoller::find(int fd, bool isForRead)
 {
-	FDHandlers & handlers =
+	const FDHandlers & handlers =
 		isForRead ? fdReadHandlers_ : fdWriteHandlers_;
 
-	FDHandlers::iterator iter = handlers.find(fd);
+	return EventPoller::findHandler(handlers, fd);
+}
+
+//-------------------------------------------------------------------------------------
+InputNotificationHandler* EventPoller::findHandler(const FDHandlers & handlers, int fd)
+{
+#ifdef _WIN32
+	FDHandlers::const_iterator iter = handlers.find(fd);
 	
 	if(iter == handlers.end())
 		return NULL;
 
 	return iter->second;
+#else
+	if(fd < 0 || fd >= (int)handlers.size())
+		return NULL;
+
+	return handlers[fd];
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+void EventPoller::setHandler(FDHandlers & handlers, int fd, InputNotificationHandler * handler)
+{
+#ifdef _WIN32
+	if(handler == NULL)
+		handlers.erase(fd);
+	else
+		handlers[fd] = handler;
+#else
+	if(fd < 0)
+		return;
+
+	if(fd >= (int)handlers.size())
+	{
+		if(handler == NULL)
+			return;
+
+		handlers.resize(fd + 1, NULL);
+	}
+
+	handlers[fd] = handler;
+#endif
 }
 
 //-------------------------------------------------------------------------------------
@@ -168,6 +205,7 @@ int EventPoller::maxFD() const
 int EventPoller::maxFD(const FDHandlers & handlerMap)
 {
 	int maxFD = -1;
+#ifdef _WIN32
 	FDHandlers::const_iterator iFDHandler = handlerMap.begin();
 	while (iFDHandler != handlerMap.end())
 	{
@@ -177,6 +215,16 @@ int EventPoller::maxFD(const FDHandlers & handlerMap)
 		}
 		++iFDHandler;
 	}
+#else
+	for (int fd = (int)handlerMap.size() - 1; fd >= 0; --fd)
+	{
+		if (handlerMap[fd] != NULL)
+		{
+			maxFD = fd;
+			break;
+		}
+	}
+#endif
 	return maxFD;
 }
 
@@ -188,7 +236,7 @@ public:
 	SelectPoller();
 
 protected:
-	virtual bool doRegisterForRead(int fd);
+	virtual bool doRegisterForRead(int fd, bool edgeTriggered);
 	virtual bool doRegisterForWrite(int fd);
 
 	virtual bool doDeregisterForRead(int fd);
@@ -339,8 +387,10 @@ int SelectPoller::processPendingEvents(double maxWait)
 }
 
 //-------------------------------------------------------------------------------------
-bool SelectPoller::doRegisterForRead(int fd)
+bool SelectPoller::doRegisterForRead(int fd, bool edgeTriggered)
 {
+	// selectֻ֧ˮƽ edgeTriggered
+
 #ifndef _WIN32
 	if ((fd < 0) || (FD_SETSIZE <= fd))
 	{
@@ -483,30 +533,41 @@ public:
 	int getFileDescriptor() const { return epfd_; }
 
 protected:
-	virtual bool doRegisterForRead(int fd)
-		{ return this->doRegister(fd, true, true); }
+	virtual bool doRegisterForRead(int fd, bool edgeTriggered)
+		{ return this->doRegister(fd, true, true, edgeTriggered); }
 
 	virtual bool doRegisterForWrite(int fd)
-		{ return this->doRegister(fd, false, true); }
+		{ return this->doRegister(fd, false, true, false); }
 
 	virtual bool doDeregisterForRead(int fd)
-		{ return this->doRegister(fd, true, false); }
+		{ return this->doRegister(fd, true, false, false); }
 
 	virtual bool doDeregisterForWrite(int fd)
-		{ return this->doRegister(fd, false, false); }
+		{ return this->doRegister(fd, false, false, false); }
 
 	virtual int processPendingEvents(double maxWait);
 
-	bool doRegister(int fd, bool isRead, bool isRegister);
+	bool doRegister(int fd, bool isRead, bool isRegister, bool edgeTriggered);
+
+	bool isEdgeTriggered(int fd) const
+		{ return fd >= 0 && fd < (int)edgeTriggeredFDs_.size() && edgeTriggeredFDs_[fd]; }
 
 private:
 	// epoll file descriptor
 	int epfd_;
+
+	// epoll_wait¼飬 Сg_pollerMaxEvents
+	std::vector<struct epoll_event> events_;
+
+	// ԱԵʽעfd ޸עʱҪEPOLLET
+	std::vector<bool> edgeTriggeredFDs_;
 };
 
 //-------------------------------------------------------------------------------------
 EPoller::EPoller(int expectedSize) :
-	epfd_(epoll_create(expectedSize))
+	epfd_(epoll_create(expectedSize)),
+	events_(),
+	edgeTriggeredFDs_()
 {
 	if (epfd_ == -1)
 	{
@@ -525,7 +586,7 @@ EPoller::~EPoller()
 }
 
 //-------------------------------------------------------------------------------------
-bool EPoller::doRegister(int fd, bool isRead, bool isRegister)
+bool EPoller::doRegister(int fd, bool isRead, bool isRegister, bool edgeTriggered)
 {
 	struct epoll_event ev;
 	memset(&ev, 0, sizeof(ev)); // stop valgrind warning
@@ -533,6 +594,22 @@ bool EPoller::doRegister(int fd, bool isRead, bool isRegister)
 
 	ev.data.fd = fd;
 
+	// עʱfdǷʹñԵ עʱ
+	if (isRead && fd >= 0)
+	{
+		if (isRegister && edgeTriggered)
+		{
+			if (fd >= (int)edgeTriggeredFDs_.size())
+				edgeTriggeredFDs_.resize(fd + 1, false);
+
+			edgeTriggeredFDs_[fd] = true;
+		}
+		else if (fd < (int)edgeTriggeredFDs_.size())
+		{
+			edgeTriggeredFDs_[fd] = false;
+		}
+	}
+
 	// Handle the case where the file is already registered for the opposite
 	// action.
 	if (this->isRegistered(fd, !isRead))
@@ -544,11 +621,15 @@ bool EPoller::doRegister(int fd, bool isRead, bool isRegister)
 	}
 	else
 	{
-		// TODO: Could be good to use EPOLLET (leave like select for now).
+		// ԵֻڴܹһΰsocketEAGAINʱʹ
 		ev.events = isRead ? EPOLLIN : EPOLLOUT;
 		op = isRegister ? EPOLL_CTL_ADD : EPOLL_CTL_DEL;
 	}
 
+	// EPOLLETfd дͬʱעʱд¼ҲǱԵ
+	if (this->isEdgeTriggered(fd))
+		ev.events |= EPOLLET;
+
 	if (epoll_ctl(epfd_, op, fd, &ev) < 0)
 	{
 		const char* MESSAGE = "EPoller::doRegister: Failed to %s %s file "
@@ -579,8 +660,11 @@ bool EPoller::doRegister(int fd, bool isRead, bool isRegister)
 //-------------------------------------------------------------------------------------
 int EPoller::processPendingEvents(double maxWait)
 {
-	const int MAX_EVENTS = 10;
-	struct epoll_event events[ MAX_EVENTS ];
+	const int maxEvents = g_pollerMaxEvents > 0 ? (int)g_pollerMaxEvents : 1;
+	if ((int)events_.size() != maxEvents)
+		events_.resize(maxEvents);
+
+	struct epoll_event* events = &events_[0];
 	int maxWaitInMilliseconds = int(ceil(maxWait * 1000));
 
 #if ENABLE_WATCHERS
@@ -590,7 +674,7 @@ int EPoller::processPendingEvents(double maxWait)
 #endif
 
 	KBEConcurrency::startMainThreadIdling();
-	int nfds = epoll_wait(epfd_, events, MAX_EVENTS, maxWaitInMilliseconds);
+	int nfds = epoll_wait(epfd_, events, maxEvents, maxWaitInMilliseconds);
 	KBEConcurrency::endMainThreadIdling();
 
 
@@ -33,7 +33,13 @@ namespace Mercury
 {
 	
 class InputNotificationHandler;
+
+#ifdef _WIN32
 typedef std::map<int, InputNotificationHandler *> FDHandlers;
+#else
+// unixfdǴ0ʼС ֱfdΪ±꣬ ַ¼ʱO(1)ҵ
+typedef std::vector<InputNotificationHandler *> FDHandlers;
+#endif
 
 class EventPoller : public InputNotificationHandler
 {
@@ -41,7 +47,7 @@ public:
 	EventPoller();
 	virtual ~EventPoller();
 
-	bool registerForRead(int fd, InputNotificationHandler * handler);
+	bool registerForRead(int fd, InputNotificationHandler * handler, bool edgeTriggered = false);
 	bool registerForWrite(int fd, InputNotificationHandler * handler);
 
 	bool deregisterForRead(int fd);
@@ -59,7 +65,7 @@ public:
 
 	InputNotificationHandler* find(int fd, bool isForRead);
 protected:
-	virtual bool doRegisterForRead(int fd) = 0;
+	virtual bool doRegisterForRead(int fd, bool edgeTriggered) = 0;
 	virtual bool doRegisterForWrite(int fd) = 0;
 
 	virtual bool doDeregisterForRead(int fd) = 0;
@@ -77,6 +83,9 @@ protected:
 
 private:
 	static int maxFD(const FDHandlers & handlerMap);
+	static InputNotificationHandler* findHandler(const FDHandlers & handlers, int fd);
+	static void setHandler(FDHandlers & handlers, int fd, InputNotificationHandler * handler);
+
 	FDHandlers fdReadHandlers_;
 	FDHandlers fdWriteHandlers_;
 
@@ -37,6 +37,7 @@ static Mercury::FixedMessages* g_fm;
 //-------------------------------------------------------------------------------------
 MessageHandlers::MessageHandlers():
 msgHandlers_(),
+msgHandlerTable_(),
 msgID_(1),
 exposedMessages_()
 {
@@ -197,19 +198,17 @@ MessageHandler* MessageHandlers::add(std::string ihName, MessageArgs* args,
 	//if(isfixedMsg)
 	//	printf("\t\t!!!message is fixed.!!!\n");
 
-	return msgHandlers_[msgHandler->msgID];
-}
-
-//-------------------------------------------------------------------------------------
-MessageHandler* MessageHandlers::find(MessageID msgID)
-{
-	MessageHandlerMap::iterator iter = msgHandlers_.find(msgID);
-	if(iter != msgHandlers_.end())
+	// ϢIDС ֱIDΪ±꽨ַ
+	if(msgHandler->msgID >= msgHandlerTable_.size())
 	{
-		return iter->second;
-	};
-	
-	return NULL;
+		MessageHandlerSlot emptySlot = {NULL, 0};
+		msgHandlerTable_.resize(msgHandler->msgID + 1, emptySlot);
+	}
+
+	msgHandlerTable_[msgHandler->msgID].pHandler = msgHandler;
+	msgHandlerTable_[msgHandler->msgID].msgLen = msgHandler->msgLen;
+
+	return msgHandlers_[msgHandler->msgID];
 }
 
 //-------------------------------------------------------------------------------------
@@ -116,6 +116,19 @@ class MessageHandlers
 public:
 	static Mercury::MessageHandlers* pMainMessageHandlers;
 	typedef std::map<MessageID, MessageHandler*> MessageHandlerMap;
+
+	/**
+		ϢIDΪ±ķַ ϢֱӴڱУ
+		ÿϢʱֻһ±
+	*/
+	struct MessageHandlerSlot
+	{
+		MessageHandler* pHandler;
+		int32 msgLen;
+	};
+
+	typedef std::vector<MessageHandlerSlot> MessageHandlerTable;
+
 	MessageHandlers();
 	~MessageHandlers();
 	
@@ -124,7 +137,21 @@ public:
 	
 	bool pushExposedMessage(std::string msgname);
 
-	MessageHandler* find(MessageID msgID);
+	MessageHandler* find(MessageID msgID)
+	{
+		if(msgID >= msgHandlerTable_.size())
+			return NULL;
+
+		return msgHandlerTable_[msgID].pHandler;
+	}
+
+	const MessageHandlerSlot* findSlot(MessageID msgID) const
+	{
+		if(msgID >= msgHandlerTable_.size() || msgHandlerTable_[msgID].pHandler == NULL)
+			return NULL;
+
+		return &msgHandlerTable_[msgID];
+	}
 	
 	MessageID lastMsgID() {return msgID_ - 1;}
 
@@ -136,6 +163,7 @@ public:
 	const MessageHandlerMap& msgHandlers(){ return msgHandlers_; }
 private:
 	MessageHandlerMap msgHandlers_;
+	MessageHandlerTable msgHandlerTable_;
 	MessageID msgID_;
 
 	std::vector< std::string > exposedMessages_;
@@ -33,6 +33,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "network/delayed_channels.hpp"
 #include "network/interfaces.hpp"
 #include "network/message_handler.hpp"
+#include "network/reliable_udp_filter.hpp"
 
 namespace KBEngine { 
 namespace Mercury
@@ -40,6 +41,9 @@ namespace Mercury
 const int NetworkInterface::RECV_BUFFER_SIZE = 16 * 1024 * 1024; // 16MB
 const char * NetworkInterface::USE_KBEMACHINED = "kbemachined";
 
+// ۺϷʱһϵͳЯİ
+static const size_t SENDV_MAX_PACKETS = 64;
+
 //-------------------------------------------------------------------------------------
 NetworkInterface::NetworkInterface(Mercury::EventDispatcher * pMainDispatcher,
 		int32 extlisteningPort_min, int32 extlisteningPort_max, const char * extlisteningInterface,
@@ -58,7 +62,14 @@ NetworkInterface::NetworkInterface(Mercury::EventDispatcher * pMainDispatcher,
 	pChannelTimeOutHandler_(NULL),
 	pChannelDeregisterHandler_(NULL),
 	isExternal_(extlisteningPort_min != -1),
-	numExtChannels_(0)
+	numExtChannels_(0),
+	gatheredPackets_(),
+	activeChannels_(),
+	processingChannels_(),
+	reapChannels_(),
+	reliableUDPFilters_(),
+	flushingReliableUDPFilters_(),
+	reliableUDPTimerHandle_()
 {
 	if(isExternal())
 	{
@@ -112,6 +123,8 @@ NetworkInterface::~NetworkInterface()
 		}
 	}
 
+	this->clearChannelLists();
+	reliableUDPTimerHandle_.cancel();
 	this->detach();
 	this->closeSocket();
 
@@ -347,6 +360,12 @@ void NetworkInterface::sendIfDelayed(Channel & channel)
 //-------------------------------------------------------------------------------------
 void NetworkInterface::handleTimeout(TimerHandle handle, void * arg)
 {
+	if(handle == reliableUDPTimerHandle_)
+	{
+		flushReliableUDPFilters();
+		return;
+	}
+
 	INFO_MSG(boost::format("NetworkInterface::handleTimeout: EXTERNAL(%1%), INTERNAL(%2%).\n") % 
 		extaddr().c_str() % intaddr().c_str());
 }
@@ -535,6 +554,189 @@ Reason NetworkInterface::send(Bundle & bundle, Channel * pChannel)
 	return reason;
 }
 
+//-------------------------------------------------------------------------------------
+Reason NetworkInterface::sendBundles(std::vector<Bundle*>& bundles, Channel * pChannel)
+{
+	Reason reason = REASON_SUCCESS;
+	std::vector<Bundle*>::iterator iter = bundles.begin();
+
+	bool gather = pChannel->pFilter() == NULL;
+
+#if !defined(unix)
+	gather = false;
+#elif !defined(__linux__)
+	for(; iter != bundles.end(); iter++)
+	{
+		if(!(*iter)->isTCPPacket())
+		{
+			gather = false;
+			break;
+		}
+	}
+
+	iter = bundles.begin();
+#endif
+
+	// Ҫ(ܵ) Ȼbundle
+	if(!gather)
+	{
+		if(bundles.size() > 1 && pChannel->channelType() != Channel::CHANNEL_WEB)
+		{
+			bool allTCP = true;
+			for(; iter != bundles.end(); iter++)
+			{
+				if(!(*iter)->isTCPPacket())
+				{
+					allTCP = false;
+					break;
+				}
+			}
+
+			if(allTCP)
+				return sendCoalescedBundles(bundles, pChannel);
+
+			iter = bundles.begin();
+		}
+
+		for(; iter != bundles.end(); iter++)
+		{
+			(*iter)->send(*this, pChannel);
+		}
+
+		return reason;
+	}
+
+	gatheredPackets_.clear();
+
+	for(; iter != bundles.end(); iter++)
+	{
+		Bundle* pBundle = (*iter);
+		pBundle->pChannel(pChannel);
+		pBundle->finish();
+
+		const Bundle::Packets& packets = pBundle->packets();
+		Bundle::Packets::const_iterator piter = packets.begin();
+		for (; piter != packets.end(); piter++)
+		{
+			this->onPacketOut(*(*piter));
+			(*piter)->sentSize = 0;
+			gatheredPackets_.push_back((*piter));
+		}
+	}
+
+	if(!pChannel->isCondemn())
+	{
+		reason = this->basicSendvWithRetries(pChannel);
+	}
+	else
+	{
+		ERROR_MSG(boost::format("NetworkInterface::sendBundles: channel(%1%) send error, reason=%2%.\n") % pChannel->c_str() % 
+			reasonToString(REASON_CHANNEL_CONDEMN));
+
+		reason = REASON_CHANNEL_CONDEMN;
+	}
+
+	gatheredPackets_.clear();
+
+	for(iter = bundles.begin(); iter != bundles.end(); iter++)
+	{
+		(*iter)->onSendCompleted();
+	}
+
+	return reason;
+}
+
+//-------------------------------------------------------------------------------------
+Reason NetworkInterface::sendCoalescedBundles(std::vector<Bundle*>& bundles, Channel * pChannel)
+{
+	Reason reason = REASON_SUCCESS;
+	std::vector<Bundle*>::iterator iter = bundles.begin();
+
+	size_t packetmaxsize = (size_t)(*iter)->packetMaxSize();
+	Packet* pOutPacket = NULL;
+
+	gatheredPackets_.clear();
+	coalescedPackets_.clear();
+
+	for(; iter != bundles.end(); iter++)
+	{
+		Bundle* pBundle = (*iter);
+		pBundle->pChannel(pChannel);
+		pBundle->finish();
+
+		const Bundle::Packets& packets = pBundle->packets();
+		Bundle::Packets::const_iterator piter = packets.begin();
+		for (; piter != packets.end(); piter++)
+		{
+			Packet* pPacket = (*piter);
+
+			// Ѿװİֱӷͣ Ҫ
+			if(pPacket->totalSize() >= packetmaxsize)
+			{
+				pOutPacket = NULL;
+				gatheredPackets_.push_back(pPacket);
+				continue;
+			}
+
+			const uint8* pData = pPacket->data() + pPacket->rpos();
+			size_t remain = pPacket->totalSize();
+
+			while(remain > 0)
+			{
+				if(pOutPacket == NULL || pOutPacket->wpos() >= packetmaxsize)
+				{
+					pOutPacket = TCPPacket::ObjPool().createObject();
+					coalescedPackets_.push_back(pOutPacket);
+					gatheredPackets_.push_back(pOutPacket);
+				}
+
+				size_t len = packetmaxsize - pOutPacket->wpos();
+				if(len > remain)
+					len = remain;
+
+				pOutPacket->append(pData, len);
+				pData += len;
+				remain -= len;
+			}
+		}
+	}
+
+	if(!pChannel->isCondemn())
+	{
+		std::vector<Packet*>::iterator piter = gatheredPackets_.begin();
+		for(; piter != gatheredPackets_.end(); piter++)
+		{
+			reason = this->sendPacket((*piter), pChannel);
+			if(reason != REASON_SUCCESS)
+				break; 
+		}
+	}
+	else
+	{
+		ERROR_MSG(boost::format("NetworkInterface::sendCoalescedBundles: channel(%1%) send error, reason=%2%.\n") % pChannel->c_str() % 
+			reasonToString(REASON_CHANNEL_CONDEMN));
+
+		reason = REASON_CHANNEL_CONDEMN;
+	}
+
+	gatheredPackets_.clear();
+
+	std::vector<Packet*>::iterator piter = coalescedPackets_.begin();
+	for(; piter != coalescedPackets_.end(); piter++)
+	{
+		TCPPacket::ObjPool().reclaimObject(static_cast<TCPPacket*>((*piter)));
+	}
+
+	coalescedPackets_.clear();
+
+	for(iter = bundles.begin(); iter != bundles.end(); iter++)
+	{
+		(*iter)->onSendCompleted();
+	}
+
+	return reason;
+}
+
 //-------------------------------------------------------------------------------------
 Reason NetworkInterface::sendPacket(Packet * pPacket, Channel * pChannel)
 {
@@ -646,6 +848,174 @@ Reason NetworkInterface::basicSendSingleTry(Channel * pChannel, Packet * pPacket
 	}
 }
 
+//-------------------------------------------------------------------------------------
+Reason NetworkInterface::basicSendvWithRetries(Channel * pChannel)
+{
+	if(pChannel->isCondemn())
+	{
+		return REASON_CHANNEL_CONDEMN;
+	}
+
+	// Է͵Ĵ
+	uint32 retries = 0;
+	Reason reason;
+	
+	// Ѿİ дİsentSize¼
+	size_t sentPackets = 0;
+
+	while(true)
+	{
+		retries++;
+
+		reason = this->basicSendvSingleTry(pChannel, sentPackets);
+
+		if (reason == REASON_SUCCESS)
+			return reason;
+
+		// ͳִôǿԼһΣ ⲿͨ3˳
+		if (reason == REASON_NO_SUCH_PORT && retries <= 3)
+		{
+			continue;
+		}
+
+		// ϵͳͻѾˣǵȴ10ms
+		if (reason == REASON_RESOURCE_UNAVAILABLE || reason == REASON_GENERAL_NETWORK)
+		{
+			if(pChannel->isInternal())
+			{
+				if(g_intReSendRetries > 0 && retries > g_intReSendRetries)
+				{
+					pChannel->condemn();
+					break;
+				}
+			}
+			else
+			{
+				if(g_extReSendRetries > 0 && retries > g_extReSendRetries)
+				{
+					pChannel->condemn();
+					break;
+				}
+			}
+
+			WARNING_MSG(boost::format("NetworkInterface::basicSendvWithRetries: "
+				"Transmit queue full, waiting for space... (%1%)\n") %
+				retries );
+			
+			KBEngine::sleep(pChannel->isInternal() ? g_intReSendInterval : g_extReSendInterval);
+			continue;
+		}
+
+		break;
+	}
+
+	// Դ
+	ERROR_MSG(boost::format("NetworkInterface::basicSendvWithRetries: %1% packets discarded(reason=%2%).\n") % 
+		(gatheredPackets_.size() - sentPackets) % (reasonToString(reason)));
+
+	return reason;
+}
+
+//-------------------------------------------------------------------------------------
+Reason NetworkInterface::basicSendvSingleTry(Channel * pChannel, size_t& sentPackets)
+{
+	if(pChannel->isCondemn())
+	{
+		ERROR_MSG(boost::format("NetworkInterface::basicSendvSingleTry: channel(%1%) send error, reason=%2%.\n") % pChannel->c_str() % 
+			reasonToString(REASON_CHANNEL_CONDEMN));
+		return REASON_CHANNEL_CONDEMN;
+	}
+
+#ifdef unix
+	EndPoint * endpoint = pChannel->endpoint();
+	const size_t packetsSize = gatheredPackets_.size();
+
+	while(sentPackets < packetsSize)
+	{
+		Packet* pFirstPacket = gatheredPackets_[sentPackets];
+		struct iovec iov[SENDV_MAX_PACKETS];
+		int iovcnt = 0;
+		int totalSize = 0;
+		int len = 0;
+
+		size_t i = sentPackets;
+		for(; i < packetsSize && iovcnt < (int)SENDV_MAX_PACKETS; ++i)
+		{
+			Packet* pPacket = gatheredPackets_[i];
+			KBE_ASSERT(pPacket->rpos() == 0);
+
+			iov[iovcnt].iov_base = pPacket->data() + pPacket->sentSize;
+			iov[iovcnt].iov_len = pPacket->totalSize() - pPacket->sentSize;
+			totalSize += iov[iovcnt].iov_len;
+			++iovcnt;
+		}
+
+		if(totalSize == 0)
+		{
+			sentPackets = i;
+			continue;
+		}
+
+		if(pFirstPacket->isTCPPacket())
+		{
+			len = endpoint->sendv(iov, iovcnt);
+
+			// дֽƽÿķͽȣ һֻдһ
+			int left = len;
+			while(left > 0)
+			{
+				Packet* pPacket = gatheredPackets_[sentPackets];
+				int remain = pPacket->totalSize() - pPacket->sentSize;
+
+				if(left < remain)
+				{
+					pPacket->sentSize += left;
+					break;
+				}
+
+				pPacket->sentSize += remain;
+				left -= remain;
+				++sentPackets;
+			}
+		}
+		else
+		{
+#if defined(__linux__)
+			// UDPÿһݱ
+			struct mmsghdr msgs[SENDV_MAX_PACKETS];
+			memset(msgs, 0, sizeof(struct mmsghdr) * iovcnt);
+
+			for(int m = 0; m < iovcnt; ++m)
+			{
+				msgs[m].msg_hdr.msg_iov = &iov[m];
+				msgs[m].msg_hdr.msg_iovlen = 1;
+			}
+
+			len = endpoint->sendmmsg(msgs, iovcnt);
+
+			for(int m = 0; m < len; ++m)
+			{
+				Packet* pPacket = gatheredPackets_[sentPackets++];
+				pPacket->sentSize = pPacket->totalSize();
+			}
+#else
+			KBE_ASSERT(false && "NetworkInterface::basicSendvSingleTry: sendmmsg is not supported!\n");
+#endif
+		}
+
+		if(len <= 0)
+		{
+			return NetworkInterface::getSendErrorReason(endpoint, len, totalSize);
+		}
+	}
+
+	return REASON_SUCCESS;
+#else
+	KBE_ASSERT(false && "NetworkInterface::basicSendvSingleTry: writev is not supported!\n");
+	return REASON_GENERAL_NETWORK;
+#endif
+}
+
 //-------------------------------------------------------------------------------------
 Reason NetworkInterface::getSendErrorReason(const EndPoint * endpoint, 
 											int retSendSize, int packetTotalSize)
@@ -716,24 +1086,164 @@ void NetworkInterface::onPacketOut(const Packet & packet)
 //-------------------------------------------------------------------------------------
 void NetworkInterface::processAllChannelPackets(KBEngine::Mercury::MessageHandlers* pMsgHandlers)
 {
-	ChannelMap::iterator iter = channelMap_.begin();
-	for(; iter != channelMap_.end(); )
+	// ֻݵͨ µݽһ
+	processingChannels_.swap(activeChannels_);
+
+	std::vector<Channel*>::iterator iter = processingChannels_.begin();
+	for(; iter != processingChannels_.end(); ++iter)
 	{
-		Mercury::Channel* pChannel = iter->second;
+		Mercury::Channel* pChannel = (*iter);
+		pChannel->inActiveList(false);
 
-		if(pChannel->isDestroyed() || pChannel->isCondemn())
+		// ǰchannelMap_һ£ ֻעڱӿеͨ
+		if(!pChannel->isDestroyed() && !pChannel->isCondemn() && 
+			pChannel->endpoint() != NULL && findChannel(pChannel->addr()) == pChannel)
 		{
-			++iter;
-			deregisterChannel(pChannel);
-			pChannel->destroy();
+			pChannel->processPackets(pMsgHandlers);
 		}
-		else
+
+		pChannel->decRef();
+	}
+
+	processingChannels_.clear();
+
+	this->reapChannels();
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkInterface::onChannelActive(Channel * pChannel)
+{
+	if(pChannel->inActiveList())
+		return;
+
+	pChannel->inActiveList(true);
+	pChannel->incRef();
+	activeChannels_.push_back(pChannel);
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkInterface::onChannelCondemn(Channel * pChannel)
+{
+	if(pChannel->inReapList())
+		return;
+
+	pChannel->inReapList(true);
+	pChannel->incRef();
+	reapChannels_.push_back(pChannel);
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkInterface::reapChannels()
+{
+	if(reapChannels_.size() == 0)
+		return;
+
+	std::vector<Channel*> channels;
+	channels.swap(reapChannels_);
+
+	std::vector<Channel*>::iterator iter = channels.begin();
+	for(; iter != channels.end(); ++iter)
+	{
+		Mercury::Channel* pChannel = (*iter);
+
+		if((pChannel->isDestroyed() || pChannel->isCondemn()) && 
+			pChannel->endpoint() != NULL && findChannel(pChannel->addr()) == pChannel)
 		{
-			pChannel->processPackets(pMsgHandlers);
-			++iter;
+			deregisterChannel(pChannel);
+
+			if(!pChannel->isDestroyed())
+				pChannel->destroy();
 		}
+
+		// ǣ destroyٴνб
+		pChannel->inReapList(false);
+		pChannel->decRef();
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkInterface::onReliableUDPPending(ReliableUDPFilter * pFilter)
+{
+	if(pFilter->inPendingList())
+		return;
+
+	pFilter->inPendingList(true);
+	reliableUDPFilters_.push_back(pFilter);
+
+	if(!reliableUDPTimerHandle_.isSet())
+		reliableUDPTimerHandle_ = dispatcher().addTimer(RELIABLE_UDP_INTERVAL * 1000, this);
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkInterface::onReliableUDPFilterGone(ReliableUDPFilter * pFilter)
+{
+	if(!pFilter->inPendingList())
+		return;
+
+	pFilter->inPendingList(false);
+
+	std::vector<ReliableUDPFilter*>::iterator iter = std::find(reliableUDPFilters_.begin(), 
+		reliableUDPFilters_.end(), pFilter);
+
+	if(iter != reliableUDPFilters_.end())
+	{
+		(*iter) = reliableUDPFilters_.back();
+		reliableUDPFilters_.pop_back();
+	}
+
+	// ˢµбÿգ ʱ
+	std::replace(flushingReliableUDPFilters_.begin(), flushingReliableUDPFilters_.end(), 
+		pFilter, (ReliableUDPFilter*)NULL);
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkInterface::flushReliableUDPFilters()
+{
+	uint32 now = getSystemTime();
+
+	// ˢºݵĹ¼б
+	flushingReliableUDPFilters_.swap(reliableUDPFilters_);
+
+	for(size_t i = 0; i < flushingReliableUDPFilters_.size(); ++i)
+	{
+		ReliableUDPFilter* pFilter = flushingReliableUDPFilters_[i];
+		if(pFilter == NULL)
+			continue;
+
+		pFilter->inPendingList(false);
+
+		if(pFilter->tick(now))
+			onReliableUDPPending(pFilter);
+	}
+
+	flushingReliableUDPFilters_.clear();
+
+	if(reliableUDPFilters_.empty())
+		reliableUDPTimerHandle_.cancel();
+}
+
+//-------------------------------------------------------------------------------------
+void NetworkInterface::clearChannelLists()
+{
+	std::vector<Channel*>::iterator iter = activeChannels_.begin();
+	for(; iter != activeChannels_.end(); ++iter)
+	{
+		(*iter)->inActiveList(false);
+		(*iter)->decRef();
 	}
+
+	activeChannels_.clear();
+
+	iter = reapChannels_.begin();
+	for(; iter != reapChannels_.end(); ++iter)
+	{
+		(*iter)->inReapList(false);
+		(*iter)->decRef();
+	}
+
+	reapChannels_.clear();
 }
+
 //-------------------------------------------------------------------------------------
 }
 }
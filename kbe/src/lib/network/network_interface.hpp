@@ -41,13 +41,14 @@ class ListenerReceiver;
 class Packet;
 class EventDispatcher;
 class MessageHandlers;
+class ReliableUDPFilter;
 
 class NetworkInterface : public TimerHandler
 {
 public:
 	static const int RECV_BUFFER_SIZE;
 	static const char * USE_KBEMACHINED;
-	typedef std::map<Address, Channel *>	ChannelMap;
+	typedef KBEUnordered_map<Address, Channel *, AddressHash>	ChannelMap;
 	
 	NetworkInterface(EventDispatcher * pMainDispatcher,
 		int32 extlisteningPort_min = -1, int32 extlisteningPort_max = -1, const char * extlisteningInterface = "",
@@ -101,11 +102,26 @@ public:
 		
 	/**  */
 	Reason send(Bundle & bundle, Channel * pChannel = NULL);
+
+	/**
+		ͨдbundleİۺ writev(TCP)sendmmsg(UDP)
+		һϵͳ÷ ͨйƽ̨֧ʱbundle
+	*/
+	Reason sendBundles(std::vector<Bundle*>& bundles, Channel * pChannel);
+
+	/**
+		ܾۺϷʱ(Ҫ) ѶTCP bundleϢܵؿİͣ
+		СϢɵİܴϵͳ
+	*/
+	Reason sendCoalescedBundles(std::vector<Bundle*>& bundles, Channel * pChannel);
+
 	Reason sendPacket(Packet * pPacket, Channel * pChannel = NULL);
 	void sendIfDelayed(Channel & channel);
 	void delayedSend(Channel & channel);
 	Reason basicSendSingleTry(Channel * pChannel, Packet * pPacket);
 	Reason basicSendWithRetries(Channel * pChannel, Packet * pPacket);
+	Reason basicSendvSingleTry(Channel * pChannel, size_t& sentPackets);
+	Reason basicSendvWithRetries(Channel * pChannel);
 	
 	bool good() const{ return (!isExternal() || extEndpoint_.good()) && (intEndpoint_.good()); }
 
@@ -114,6 +130,23 @@ public:
 
 	void onChannelGone(Channel * pChannel);
 	void onChannelTimeOut(Channel * pChannel);
+
+	/**
+		ͨյݣ б
+	*/
+	void onChannelActive(Channel * pChannel);
+
+	/**
+		ͨжΪǷ٣ б
+	*/
+	void onChannelCondemn(Channel * pChannel);
+
+	/**
+		ɿUDPдشȷϵݣ ˢб 
+		ͨһʱ бΪʱʱֹͣ
+	*/
+	void onReliableUDPPending(ReliableUDPFilter * pFilter);
+	void onReliableUDPFilterGone(ReliableUDPFilter * pFilter);
 	
 	/* 
 		Ϣ  
@@ -130,6 +163,11 @@ private:
 	virtual void handleTimeout(TimerHandle handle, void * arg);
 
 	void closeSocket();
+
+	void reapChannels();
+	void clearChannelLists();
+
+	void flushReliableUDPFilters();
 private:
 	EndPoint								extEndpoint_, intEndpoint_;
 
@@ -151,6 +189,24 @@ private:
 	const bool								isExternal_;
 
 	int32									numExtChannels_;
+
+	// sendBundlesۺϷʱռİ Աÿη
+	std::vector<Packet*>					gatheredPackets_;
+
+	// sendCoalescedBundlesƴʱ´İ Ϻ
+	std::vector<Packet*>					coalescedPackets_;
+
+	// ݵȴͨ ÿtickֻбͨ
+	std::vector<Channel*>					activeChannels_;
+	std::vector<Channel*>					processingChannels_;
+
+	// жΪǷ١ȴעͨ
+	std::vector<Channel*>					reapChannels_;
+
+	// дشȷݵĿɿUDP reliableUDPTimerHandle_ͳһˢ
+	std::vector<ReliableUDPFilter*>			reliableUDPFilters_;
+	std::vector<ReliableUDPFilter*>			flushingReliableUDPFilters_;
+	TimerHandle								reliableUDPTimerHandle_;
 };
 
 }
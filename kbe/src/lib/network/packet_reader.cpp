@@ -34,6 +34,7 @@ PacketReader::PacketReader(Channel* pChannel):
 	pFragmentDatasWpos_(0),
 	pFragmentDatasRemain_(0),
 	fragmentDatasFlag_(FRAGMENT_DATA_UNKNOW),
+	pFragmentBodyStream_(NULL),
 	pFragmentStream_(NULL),
 	currMsgID_(0),
 	currMsgLen_(0),
@@ -57,9 +58,19 @@ void PacketReader::reset()
 	currMsgID_ = 0;
 	currMsgLen_ = 0;
 	
-	SAFE_RELEASE_ARRAY(pFragmentDatas_);
-	MemoryStream::ObjPool().reclaimObject(pFragmentStream_);
-	pFragmentStream_ = NULL;
+	pFragmentDatas_ = NULL;
+
+	if(pFragmentBodyStream_)
+	{
+		MemoryStream::ObjPool().reclaimObject(pFragmentBodyStream_);
+		pFragmentBodyStream_ = NULL;
+	}
+
+	if(pFragmentStream_)
+	{
+		MemoryStream::ObjPool().reclaimObject(pFragmentStream_);
+		pFragmentStream_ = NULL;
+	}
 }
 
 //-------------------------------------------------------------------------------------
@@ -81,7 +92,8 @@ void PacketReader::processMessages(KBEngine::Mercury::MessageHandlers* pMsgHandl
 				pPacket->messageID(currMsgID_);
 			}
 
-			Mercury::MessageHandler* pMsgHandler = pMsgHandlers->find(currMsgID_);
+			const MessageHandlers::MessageHandlerSlot* pMsgSlot = pMsgHandlers->findSlot(currMsgID_);
+			Mercury::MessageHandler* pMsgHandler = pMsgSlot != NULL ? pMsgSlot->pHandler : NULL;
 
 			if(pMsgHandler == NULL)
 			{
@@ -109,7 +121,7 @@ void PacketReader::processMessages(KBEngine::Mercury::MessageHandlers* pMsgHandl
 			
 			if(currMsgLen_ == 0)
 			{
-				if(pMsgHandler->msgLen == MERCURY_VARIABLE_MESSAGE || g_packetAlwaysContainLength)
+				if(pMsgSlot->msgLen == MERCURY_VARIABLE_MESSAGE || g_packetAlwaysContainLength)
 				{
 					// Ϣ ȴһ
 					if(pPacket->opsize() < MERCURY_MESSAGE_LENGTH_SIZE)
@@ -126,7 +138,7 @@ void PacketReader::processMessages(KBEngine::Mercury::MessageHandlers* pMsgHandl
 				}
 				else
 				{
-					currMsgLen_ = pMsgHandler->msgLen;
+					currMsgLen_ = pMsgSlot->msgLen;
 					MercuryStats::getSingleton().trackMessage(MercuryStats::RECV, *pMsgHandler, 
 						currMsgLen_ + MERCURY_MESSAGE_LENGTH_SIZE);
 				}
@@ -203,11 +215,23 @@ void PacketReader::processMessages(KBEngine::Mercury::MessageHandlers* pMsgHandl
 //-------------------------------------------------------------------------------------
 void PacketReader::writeFragmentMessage(FragmentDataTypes fragmentDatasFlag, Packet* pPacket, uint32 datasize)
 {
-	KBE_ASSERT(pFragmentDatas_ == NULL);
+	KBE_ASSERT(pFragmentDatas_ == NULL && pFragmentBodyStream_ == NULL);
 
 	size_t opsize = pPacket->opsize();
 	pFragmentDatasRemain_ = datasize - opsize;
-	pFragmentDatas_ = new uint8[opsize + pFragmentDatasRemain_ + 1];
+
+	if(fragmentDatasFlag == FRAGMENT_DATA_MESSAGE_BODY)
+	{
+		// ϢֱƴӵսhandlerУ Ҫٿһ
+		pFragmentBodyStream_ = MemoryStream::ObjPool().createObject();
+		pFragmentBodyStream_->data_resize(datasize);
+		pFragmentDatas_ = pFragmentBodyStream_->data();
+	}
+	else
+	{
+		KBE_ASSERT(datasize <= sizeof(fragmentHeaderDatas_));
+		pFragmentDatas_ = fragmentHeaderDatas_;
+	}
 
 	fragmentDatasFlag_ = fragmentDatasFlag;
 	pFragmentDatasWpos_ = opsize;
@@ -231,8 +255,8 @@ void PacketReader::mergeFragmentMessage(Packet* pPacket)
 
 	if(pPacket->opsize() >= pFragmentDatasRemain_)
 	{
+		memcpy(pFragmentDatas_ + pFragmentDatasWpos_, pPacket->data() + pPacket->rpos(), pFragmentDatasRemain_);
 		pPacket->rpos(pPacket->rpos() + pFragmentDatasRemain_);
-		memcpy(pFragmentDatas_ + pFragmentDatasWpos_, pPacket->data(), pFragmentDatasRemain_);
 		
 		KBE_ASSERT(pFragmentStream_ == NULL);
 
@@ -247,10 +271,9 @@ void PacketReader::mergeFragmentMessage(Packet* pPacket)
 			break;
 
 		case FRAGMENT_DATA_MESSAGE_BODY:		// ϢϢȫ
-			pFragmentStream_ = MemoryStream::ObjPool().createObject();
-			pFragmentStream_->data_resize(currMsgLen_);
+			pFragmentStream_ = pFragmentBodyStream_;
+			pFragmentBodyStream_ = NULL;
 			pFragmentStream_->wpos(currMsgLen_);
-			memcpy(pFragmentStream_->data(), pFragmentDatas_, currMsgLen_);
 			break;
 
 		default:
@@ -262,11 +285,11 @@ void PacketReader::mergeFragmentMessage(Packet* pPacket)
 
 		fragmentDatasFlag_ = FRAGMENT_DATA_UNKNOW;
 		pFragmentDatasRemain_ = 0;
-		SAFE_RELEASE_ARRAY(pFragmentDatas_);
+		pFragmentDatas_ = NULL;
 	}
 	else
 	{
-		memcpy(pFragmentDatas_ + pFragmentDatasWpos_, pPacket->data(), opsize);
+		memcpy(pFragmentDatas_ + pFragmentDatasWpos_, pPacket->data() + pPacket->rpos(), opsize);
 		pFragmentDatasRemain_ -= opsize;
 		pFragmentDatasWpos_ += opsize;
 		pPacket->rpos(pPacket->rpos() + opsize);
@@ -58,10 +58,19 @@ protected:
 	virtual void writeFragmentMessage(FragmentDataTypes fragmentDatasFlag, Packet* pPacket, uint32 datasize);
 	virtual void mergeFragmentMessage(Packet* pPacket);
 protected:
+	// ָƴӵݣ ϢͷΪfragmentHeaderDatas_ ϢΪpFragmentBodyStream_Ļ
 	uint8*						pFragmentDatas_;
 	uint32						pFragmentDatasWpos_;
 	uint32						pFragmentDatasRemain_;
 	FragmentDataTypes			fragmentDatasFlag_;
+
+	// ϢID򳤶ֻмֽڣ ֱƴ
+	uint8						fragmentHeaderDatas_[MERCURY_MESSAGE_ID_SIZE + MERCURY_MESSAGE_LENGTH_SIZE];
+
+	// ϢֱƴӵУ ΪpFragmentStream_handler
+	MemoryStream*				pFragmentBodyStream_;
+
+	// ѾƴȴϢ
 	MemoryStream*				pFragmentStream_;
 	Mercury::MessageID			currMsgID_;
 	Mercury::MessageLength		currMsgLen_;
@@ -37,7 +37,8 @@ namespace Mercury
 //-------------------------------------------------------------------------------------
 PacketReceiver::PacketReceiver() :
 	pEndpoint_(NULL),
-	pNetworkInterface_(NULL)
+	pNetworkInterface_(NULL),
+	numRecvPackets_(0)
 {
 }
 
@@ -45,7 +46,8 @@ PacketReceiver::PacketReceiver() :
 PacketReceiver::PacketReceiver(EndPoint & endpoint,
 	   NetworkInterface & networkInterface	) :
 	pEndpoint_(&endpoint),
-	pNetworkInterface_(&networkInterface)
+	pNetworkInterface_(&networkInterface),
+	numRecvPackets_(0)
 {
 }
 
@@ -57,9 +59,16 @@ PacketReceiver::~PacketReceiver()
 //-------------------------------------------------------------------------------------
 int PacketReceiver::handleInputNotification(int fd)
 {
+	numRecvPackets_ = 0;
+
 	if (this->processSocket(/*expectingPacket:*/true))
 	{
-		while (this->processSocket(/*expectingPacket:*/false))
+		// socketգ ȡİޣ ĳͨռѭ
+		// ʣȻɶ һ֪ͨʱȡ
+		const uint32 limit = this->recvPacketsLimit();
+
+		while ((limit == 0 || numRecvPackets_ < limit) && 
+			this->processSocket(/*expectingPacket:*/false))
 		{
 			/* pass */;
 		}
@@ -84,6 +93,12 @@ Reason PacketReceiver::processPacket(Channel* pChannel, Packet * pPacket)
 	return this->processFilteredPacket(pChannel, pPacket);
 }
 
+//-------------------------------------------------------------------------------------
+uint32 PacketReceiver::recvPacketsLimit()
+{
+	return g_extReceivePacketsLimit;
+}
+
 //-------------------------------------------------------------------------------------
 EventDispatcher & PacketReceiver::dispatcher()
 {
@@ -60,6 +60,7 @@ public:
 	{
 		pEndpoint_ = NULL;
 		pNetworkInterface_ = NULL;
+		numRecvPackets_ = 0;
 	}
 
 	void endpoint(EndPoint* pEndpoint){ 
@@ -70,9 +71,17 @@ public:
 protected:
 	virtual bool processSocket(bool expectingPacket) = 0;
 	virtual RecvState checkSocketErrors(int len, bool expectingPacket) = 0;
+
+	/**
+		һοɶ֪ͨȡİ 0
+	*/
+	virtual uint32 recvPacketsLimit();
 protected:
 	EndPoint* pEndpoint_;
 	NetworkInterface* pNetworkInterface_;
+
+	// οɶ֪ͨѾȡİ
+	uint32 numRecvPackets_;
 };
 
 }
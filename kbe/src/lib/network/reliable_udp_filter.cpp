@@ -0,0 +1,551 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2012 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "reliable_udp_filter.hpp"
+
+#include "network/bundle.hpp"
+#include "network/channel.hpp"
+#include "network/udp_packet.hpp"
+#include "network/network_interface.hpp"
+#include "network/packet_receiver.hpp"
+
+namespace KBEngine {
+namespace Mercury
+{
+
+// ͷֶελã ǰҪȷϢ
+#define RELIABLE_UDP_UNA_POS				6
+#define RELIABLE_UDP_ACKMASK_POS			10
+#define RELIABLE_UDP_WND_POS				14
+
+//-------------------------------------------------------------------------------------
+ReliableUDPFilter::ReliableUDPFilter(Channel* pChannel):
+	pChannel_(pChannel),
+	inPendingList_(false),
+	sndBuf_(),
+	sndUna_(0),
+	sndNxt_(0),
+	numSent_(0),
+	cwnd_(RELIABLE_UDP_CWND_INIT),
+	cwndIncr_(0),
+	ssthresh_(RELIABLE_UDP_THRESH_INIT),
+	rmtWnd_(RELIABLE_UDP_RCV_WND),
+	srtt_(0),
+	rttvar_(0),
+	rto_(RELIABLE_UDP_RTO_DEF),
+	rcvBuf_(RELIABLE_UDP_RCV_WND, (Packet*)NULL),
+	rcvNxt_(0),
+	rcvBuffered_(0),
+	rcvAtBoundary_(true),
+	unreliableSndNxt_(0),
+	unreliableRcvNxt_(0),
+	pPendingUnreliable_(NULL),
+	pendingUnreliableRsn_(0),
+	ackPending_(false),
+	numRetransmits_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+ReliableUDPFilter::~ReliableUDPFilter()
+{
+	if(inPendingList_)
+		pChannel_->networkInterface().onReliableUDPFilterGone(this);
+
+	std::deque<Segment>::iterator iter = sndBuf_.begin();
+	for(; iter != sndBuf_.end(); iter++)
+	{
+		reclaimPacket((*iter).pPacket);
+	}
+
+	sndBuf_.clear();
+
+	std::vector<Packet*>::iterator riter = rcvBuf_.begin();
+	for(; riter != rcvBuf_.end(); riter++)
+	{
+		if((*riter))
+			reclaimPacket((*riter));
+	}
+
+	rcvBuf_.clear();
+
+	if(pPendingUnreliable_)
+	{
+		reclaimPacket(pPendingUnreliable_);
+		pPendingUnreliable_ = NULL;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void ReliableUDPFilter::reclaimPacket(Packet* pPacket)
+{
+	UDPPacket::ObjPool().reclaimObject(static_cast<UDPPacket*>(pPacket));
+}
+
+//-------------------------------------------------------------------------------------
+bool ReliableUDPFilter::tick(uint32 now)
+{
+	if(pChannel_->isDestroyed() || pChannel_->isCondemn())
+		return false;
+
+	flush(now);
+	return hasPendingData();
+}
+
+//-------------------------------------------------------------------------------------
+void ReliableUDPFilter::sendSegment(UDPPacket* pPacket)
+{
+	pChannel_->networkInterface().basicSendWithRetries(pChannel_, pPacket);
+}
+
+//-------------------------------------------------------------------------------------
+void ReliableUDPFilter::onPendingData()
+{
+	pChannel_->networkInterface().onReliableUDPPending(this);
+}
+
+//-------------------------------------------------------------------------------------
+uint32 ReliableUDPFilter::currentTime() const
+{
+	return getSystemTime();
+}
+
+//-------------------------------------------------------------------------------------
+void ReliableUDPFilter::writeHeader(UDPPacket* pPacket, uint8 cmd, uint8 flags, uint32 sn)
+{
+	(*pPacket) << cmd;
+	(*pPacket) << flags;
+	(*pPacket) << sn;
+	(*pPacket) << rcvNxt_;
+	(*pPacket) << ackMask();
+	(*pPacket) << rcvWindow();
+	(*pPacket) << sndNxt_;
+}
+
+//-------------------------------------------------------------------------------------
+uint32 ReliableUDPFilter::ackMask() const
+{
+	if(rcvBuffered_ == 0)
+		return 0;
+
+	uint32 mask = 0;
+	for(uint32 i = 0; i < 32 && i + 1 < RELIABLE_UDP_RCV_WND; ++i)
+	{
+		if(rcvBuf_[(rcvNxt_ + 1 + i) % RELIABLE_UDP_RCV_WND] != NULL)
+			mask |= (1u << i);
+	}
+
+	return mask;
+}
+
+//-------------------------------------------------------------------------------------
+uint16 ReliableUDPFilter::rcvWindow() const
+{
+	return (uint16)(RELIABLE_UDP_RCV_WND - rcvBuffered_);
+}
+
+//-------------------------------------------------------------------------------------
+void ReliableUDPFilter::transmit(UDPPacket* pPacket)
+{
+	// ÿηͶЯµȷϢ
+	pPacket->put(RELIABLE_UDP_UNA_POS, rcvNxt_);
+	pPacket->put(RELIABLE_UDP_ACKMASK_POS, ackMask());
+	pPacket->put(RELIABLE_UDP_WND_POS, rcvWindow());
+	ackPending_ = false;
+
+	sendSegment(pPacket);
+}
+
+//-------------------------------------------------------------------------------------
+Reason ReliableUDPFilter::send(NetworkInterface & networkInterface, Channel * pChannel, Packet * pPacket)
+{
+	if(pPacket->isTCPPacket())
+		return networkInterface.basicSendWithRetries(pChannel, pPacket);
+
+	Bundle* pBundle = pPacket->pBundle();
+
+	uint8 flags = 0;
+	if(pBundle == NULL || pBundle->packets().empty() || pBundle->packets().back() == pPacket)
+		flags |= FLAG_MESSAGE_BOUNDARY;
+
+	// ֻװһеbundle߲ɿͨ
+	bool reliable = pBundle == NULL || pBundle->reliable() || pBundle->packets().size() > 1;
+
+	UDPPacket* pSegPacket = UDPPacket::ObjPool().createObject();
+	writeHeader(pSegPacket, reliable ? CMD_RELIABLE : CMD_UNRELIABLE, flags,
+		reliable ? sndNxt_ : unreliableSndNxt_);
+
+	pSegPacket->append(pPacket->data() + pPacket->rpos(), pPacket->totalSize());
+
+	if(!reliable)
+	{
+		++unreliableSndNxt_;
+		transmit(pSegPacket);
+		reclaimPacket(pSegPacket);
+		return REASON_SUCCESS;
+	}
+
+	Segment seg;
+	seg.pPacket = pSegPacket;
+	seg.sentTime = 0;
+	seg.resendTime = 0;
+	seg.rto = rto_;
+	seg.xmit = 0;
+	seg.fastack = 0;
+	seg.acked = false;
+
+	sndBuf_.push_back(seg);
+	++sndNxt_;
+
+	flush(currentTime());
+
+	if(hasPendingData())
+		onPendingData();
+
+	return REASON_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------
+void ReliableUDPFilter::flush(uint32 now)
+{
+	// ʹڻδ͹İ
+	uint32 wnd = cwnd_ < rmtWnd_ ? cwnd_ : rmtWnd_;
+	if(wnd == 0)
+		wnd = 1;
+
+	while(numSent_ < sndBuf_.size() && numSent_ < wnd)
+	{
+		Segment& seg = sndBuf_[numSent_++];
+		seg.xmit = 1;
+		seg.rto = rto_;
+		seg.sentTime = now;
+		seg.resendTime = now + seg.rto;
+		transmit(seg.pPacket);
+	}
+
+	bool fastResent = false;
+	bool lost = false;
+
+	for(uint32 i = 0; i < numSent_; ++i)
+	{
+		Segment& seg = sndBuf_[i];
+		if(seg.acked)
+			continue;
+
+		if(seg.fastack >= RELIABLE_UDP_FASTRESEND)
+		{
+			fastResent = true;
+		}
+		else if((int32)(now - seg.resendTime) >= 0)
+		{
+			lost = true;
+			seg.rto = seg.rto * 2 < RELIABLE_UDP_RTO_MAX ? seg.rto * 2 : RELIABLE_UDP_RTO_MAX;
+		}
+		else
+		{
+			continue;
+		}
+
+		if(seg.xmit >= RELIABLE_UDP_DEAD_LINK)
+		{
+			WARNING_MSG(boost::format("ReliableUDPFilter::flush: channel(%1%) dead link, sn=%2% retransmitted %3% times.\n") %
+				pChannel_->c_str() % (sndUna_ + i) % seg.xmit);
+
+			pChannel_->condemn();
+			return;
+		}
+
+		++seg.xmit;
+		++numRetransmits_;
+		seg.fastack = 0;
+		seg.sentTime = now;
+		seg.resendTime = now + seg.rto;
+		transmit(seg.pPacket);
+	}
+
+	// ش˵ֻǸ𶪰 ڼ; ʱ˵ӵأ 
+	if(fastResent)
+	{
+		ssthresh_ = numSent_ / 2;
+		if(ssthresh_ < RELIABLE_UDP_THRESH_MIN)
+			ssthresh_ = RELIABLE_UDP_THRESH_MIN;
+
+		cwnd_ = ssthresh_;
+		cwndIncr_ = 0;
+	}
+
+	if(lost)
+	{
+		ssthresh_ = cwnd_ / 2;
+		if(ssthresh_ < RELIABLE_UDP_THRESH_MIN)
+			ssthresh_ = RELIABLE_UDP_THRESH_MIN;
+
+		cwnd_ = 1;
+		cwndIncr_ = 0;
+	}
+
+	// ûݿЯȷʱȷ
+	if(ackPending_)
+	{
+		UDPPacket* pAckPacket = UDPPacket::ObjPool().createObject();
+		writeHeader(pAckPacket, CMD_ACK, 0, 0);
+		transmit(pAckPacket);
+		reclaimPacket(pAckPacket);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void ReliableUDPFilter::updateRTT(int32 rtt)
+{
+	if(rtt < 0)
+		return;
+
+	if(srtt_ == 0)
+	{
+		srtt_ = rtt > 0 ? rtt : 1;
+		rttvar_ = rtt / 2;
+	}
+	else
+	{
+		int32 delta = rtt - srtt_;
+		if(delta < 0)
+			delta = -delta;
+
+		rttvar_ = (3 * rttvar_ + delta) / 4;
+		srtt_ = (7 * srtt_ + rtt) / 8;
+		if(srtt_ < 1)
+			srtt_ = 1;
+	}
+
+	int32 var = 4 * rttvar_;
+	if(var < RELIABLE_UDP_INTERVAL)
+		var = RELIABLE_UDP_INTERVAL;
+
+	uint32 rto = (uint32)(srtt_ + var);
+	if(rto < RELIABLE_UDP_RTO_MIN)
+		rto = RELIABLE_UDP_RTO_MIN;
+	else if(rto > RELIABLE_UDP_RTO_MAX)
+		rto = RELIABLE_UDP_RTO_MAX;
+
+	rto_ = rto;
+}
+
+//-------------------------------------------------------------------------------------
+void ReliableUDPFilter::onSegmentAcked(Segment& seg, uint32 now)
+{
+	seg.acked = true;
+
+	// شİ޷һηͱȷϵģ RTT
+	if(seg.xmit == 1)
+		updateRTT((int32)(now - seg.sentTime));
+
+	if(cwnd_ >= RELIABLE_UDP_SND_WND_MAX)
+		return;
+
+	if(cwnd_ < ssthresh_)
+	{
+		++cwnd_;
+	}
+	else if(++cwndIncr_ >= cwnd_)
+	{
+		cwndIncr_ = 0;
+		++cwnd_;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void ReliableUDPFilter::onAck(uint32 una, uint32 ackMask, uint16 wnd, uint32 now)
+{
+	rmtWnd_ = wnd;
+
+	// ۼȷ
+	while(!sndBuf_.empty() && numSent_ > 0 && (int32)(una - sndUna_) > 0)
+	{
+		Segment& seg = sndBuf_.front();
+		if(!seg.acked)
+			onSegmentAcked(seg, now);
+
+		reclaimPacket(seg.pPacket);
+		sndBuf_.pop_front();
+		++sndUna_;
+		--numSent_;
+	}
+
+	if(ackMask == 0 || (int32)(una - sndUna_) < 0)
+		return;
+
+	// ѡȷ
+	uint32 maxAcked = 0;
+	for(uint32 i = 0; i < 32; ++i)
+	{
+		if((ackMask & (1u << i)) == 0)
+			continue;
+
+		uint32 idx = una + 1 + i - sndUna_;
+		if(idx >= numSent_)
+			break;
+
+		Segment& seg = sndBuf_[idx];
+		if(!seg.acked)
+			onSegmentAcked(seg, now);
+
+		maxAcked = idx;
+	}
+
+	// İԽȷϵİѾʧ
+	for(uint32 i = 0; i < maxAcked; ++i)
+	{
+		Segment& seg = sndBuf_[i];
+		if(!seg.acked)
+			++seg.fastack;
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void ReliableUDPFilter::deliverReliable(PacketReceiver & receiver)
+{
+	while(true)
+	{
+		uint32 slot = rcvNxt_ % RELIABLE_UDP_RCV_WND;
+		Packet* pPacket = rcvBuf_[slot];
+		if(pPacket == NULL)
+			break;
+
+		rcvBuf_[slot] = NULL;
+		--rcvBuffered_;
+		++rcvNxt_;
+
+		rcvAtBoundary_ = (pPacket->data()[1] & FLAG_MESSAGE_BOUNDARY) > 0;
+		receiver.processFilteredPacket(pChannel_, pPacket);
+
+		deliverUnreliable(receiver);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void ReliableUDPFilter::deliverUnreliable(PacketReceiver & receiver)
+{
+	// ɿͨϢ߽ҷ֮ǰĿɿѽ ſԽȴеĲɿ
+	if(pPendingUnreliable_ == NULL || !rcvAtBoundary_ || (int32)(pendingUnreliableRsn_ - rcvNxt_) > 0)
+		return;
+
+	Packet* pPendingPacket = pPendingUnreliable_;
+	pPendingUnreliable_ = NULL;
+	receiver.processFilteredPacket(pChannel_, pPendingPacket);
+}
+
+//-------------------------------------------------------------------------------------
+Reason ReliableUDPFilter::recv(Channel * pChannel, PacketReceiver & receiver, Packet * pPacket)
+{
+	if(pPacket->totalSize() < RELIABLE_UDP_HEADER_SIZE)
+	{
+		reclaimPacket(pPacket);
+		return REASON_CORRUPTED_PACKET;
+	}
+
+	uint8 cmd, flags;
+	uint32 sn, una, mask, rsn;
+	uint16 wnd;
+
+	(*pPacket) >> cmd;
+	(*pPacket) >> flags;
+	(*pPacket) >> sn;
+	(*pPacket) >> una;
+	(*pPacket) >> mask;
+	(*pPacket) >> wnd;
+	(*pPacket) >> rsn;
+
+	uint32 now = currentTime();
+	onAck(una, mask, wnd, now);
+
+	switch(cmd)
+	{
+	case CMD_RELIABLE:
+		{
+			ackPending_ = true;
+
+			int32 diff = (int32)(sn - rcvNxt_);
+			uint32 slot = sn % RELIABLE_UDP_RCV_WND;
+
+			// ظ߳մڵİ ȷϻ߶ԶҪشЩ
+			if(diff < 0 || diff >= RELIABLE_UDP_RCV_WND || rcvBuf_[slot] != NULL)
+			{
+				reclaimPacket(pPacket);
+				break;
+			}
+
+			rcvBuf_[slot] = pPacket;
+			++rcvBuffered_;
+			deliverReliable(receiver);
+		}
+		break;
+	case CMD_UNRELIABLE:
+		{
+			// ڵİ
+			if((int32)(sn - unreliableRcvNxt_) < 0)
+			{
+				reclaimPacket(pPacket);
+				break;
+			}
+
+			unreliableRcvNxt_ = sn + 1;
+
+			// ֻµһ ȴ֮ǰĿɿ
+			if(pPendingUnreliable_)
+				reclaimPacket(pPendingUnreliable_);
+
+			pPendingUnreliable_ = pPacket;
+			pendingUnreliableRsn_ = rsn;
+			deliverUnreliable(receiver);
+		}
+		break;
+	case CMD_ACK:
+		reclaimPacket(pPacket);
+		break;
+	default:
+		reclaimPacket(pPacket);
+		return REASON_CORRUPTED_PACKET;
+	};
+
+	// ȷϿڳ˷ʹ
+	if(numSent_ < sndBuf_.size())
+		flush(now);
+
+	// յĿɿһˢʱȷ
+	if(hasPendingData())
+		onPendingData();
+
+	return REASON_SUCCESS;
+}
+
+//-------------------------------------------------------------------------------------
+bool installReliableUDPFilter(Channel* pChannel)
+{
+	if(!g_extReliableUDP || pChannel->protocoltype() != PROTOCOL_UDP)
+		return false;
+
+	pChannel->pFilter(new ReliableUDPFilter(pChannel));
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+}
+}
@@ -0,0 +1,196 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2012 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef KBE_RELIABLE_UDP_FILTER_HPP
+#define KBE_RELIABLE_UDP_FILTER_HPP
+
+#include "network/packet_filter.hpp"
+
+namespace KBEngine {
+namespace Mercury
+{
+class UDPPacket;
+
+// ʱˢ(شȷ)ļ() NetworkInterfaceĶʱͳһ
+#define RELIABLE_UDP_INTERVAL				10
+
+// ӵմڴС()
+#define RELIABLE_UDP_SND_WND_MAX			256
+#define RELIABLE_UDP_RCV_WND				128
+
+// ʼӵֵ
+#define RELIABLE_UDP_CWND_INIT				4
+#define RELIABLE_UDP_THRESH_INIT			32
+#define RELIABLE_UDP_THRESH_MIN				2
+
+// شʱ()
+#define RELIABLE_UDP_RTO_MIN				30
+#define RELIABLE_UDP_RTO_DEF				200
+#define RELIABLE_UDP_RTO_MAX				60000
+
+// İԽȷϺش
+#define RELIABLE_UDP_FASTRESEND				2
+
+// һشٴδȷΪ·ѶϿ
+#define RELIABLE_UDP_DEAD_LINK				20
+
+/*
+	ɿUDP
+	UDPPacketṩͨ:
+		ɿͨ:  + ۼȷ + ѡȷλͼ Խȷϵİش ʱRTO˱ش
+					  ÿͨάӵ(ӵ⣬ ʱڼС)
+		ɿͨ: ش ֻڵİ λõױݡ
+					  bundleֻһʱͨ ֻڿɿͨϢ߽ʱŽϲ㣬
+					  ɿͨбֵϢ
+
+	ÿݱͷ(RELIABLE_UDP_HEADER_SIZE):
+		uint8 cmd | uint8 flags | uint32 sn | uint32 una | uint32 ackMask | uint16 wnd | uint32 rsn
+	unaΪԶһɿţ ackMaskĵiλʾuna+1+iѾյ wndΪԶʣմڡ
+	rsnΪʱɿͨһţ ɿҪ֮ǰĿɿȫŽϲ㣬
+	ʧشеĿɿϢ(ʵAOI)ױݰ״̬
+
+	дشȷϵʱNetworkInterfaceˢб һʱˢ£
+	ûݵͨռöʱ
+*/
+class ReliableUDPFilter : public PacketFilter
+{
+public:
+	enum Commands
+	{
+		CMD_RELIABLE = 1,
+		CMD_UNRELIABLE = 2,
+		CMD_ACK = 3
+	};
+
+	enum Flags
+	{
+		// bundleһ Ϣ߽
+		FLAG_MESSAGE_BOUNDARY = 0x01
+	};
+
+	ReliableUDPFilter(Channel* pChannel);
+	virtual ~ReliableUDPFilter();
+
+	virtual Reason send(NetworkInterface & networkInterface, Channel * pChannel, Packet * pPacket);
+
+	virtual Reason recv(Channel * pChannel, PacketReceiver & receiver, Packet * pPacket);
+
+	/**
+		ʱˢ£ شʱİȷ
+		Ƿдشȷϵ
+	*/
+	bool tick(uint32 now);
+
+	bool hasPendingData() const { return !sndBuf_.empty() || ackPending_; }
+
+	bool inPendingList() const { return inPendingList_; }
+	void inPendingList(bool v){ inPendingList_ = v; }
+
+	uint32 cwnd() const { return cwnd_; }
+	uint32 rto() const { return rto_; }
+	uint32 numRetransmits() const { return numRetransmits_; }
+
+protected:
+	struct Segment
+	{
+		UDPPacket* pPacket;
+		uint32 sentTime;
+		uint32 resendTime;
+		uint32 rto;
+		uint32 xmit;
+		uint32 fastack;
+		bool acked;
+	};
+
+	/**
+		͵·ϣ Լˢбȡǰʱ
+		Ԫ滻ΪģĶ·
+	*/
+	virtual void sendSegment(UDPPacket* pPacket);
+	virtual void onPendingData();
+	virtual uint32 currentTime() const;
+
+	void flush(uint32 now);
+	void transmit(UDPPacket* pPacket);
+	void writeHeader(UDPPacket* pPacket, uint8 cmd, uint8 flags, uint32 sn);
+
+	void deliverUnreliable(PacketReceiver & receiver);
+
+	void onAck(uint32 una, uint32 ackMask, uint16 wnd, uint32 now);
+	void onSegmentAcked(Segment& seg, uint32 now);
+	void updateRTT(int32 rtt);
+
+	void deliverReliable(PacketReceiver & receiver);
+
+	uint32 ackMask() const;
+	uint16 rcvWindow() const;
+
+	void reclaimPacket(Packet* pPacket);
+
+protected:
+	Channel*					pChannel_;
+	bool						inPendingList_;
+
+	// ͻ壬 sndBuf_[i]ΪsndUna_ + i ǰnumSent_Ѿ͹
+	std::deque<Segment>			sndBuf_;
+	uint32						sndUna_;
+	uint32						sndNxt_;
+	uint32						numSent_;
+
+	// ӵ
+	uint32						cwnd_;
+	uint32						cwndIncr_;
+	uint32						ssthresh_;
+	uint32						rmtWnd_;
+
+	// RTT()
+	int32						srtt_;
+	int32						rttvar_;
+	uint32						rto_;
+
+	// ջ壬 ŶRELIABLE_UDP_RCV_WNDȡģ򵽴İ
+	std::vector<Packet*>		rcvBuf_;
+	uint32						rcvNxt_;
+	uint32						rcvBuffered_;
+	bool						rcvAtBoundary_;
+
+	// ɿͨ
+	uint32						unreliableSndNxt_;
+	uint32						unreliableRcvNxt_;
+	Packet*						pPendingUnreliable_;
+	uint32						pendingUnreliableRsn_;
+
+	// յ˿ɿ Ҫһˢʱȷ
+	bool						ackPending_;
+
+	uint32						numRetransmits_;
+};
+
+/**
+	ⲿUDPͨ˿ɿUDPʱΪ䰲װ ˽ͨͻӷͨ
+	֤˵ķʽһ£ TCPͨӰ
+*/
+bool installReliableUDPFilter(Channel* pChannel);
+
+}
+}
+
+#endif // KBE_RELIABLE_UDP_FILTER_HPP
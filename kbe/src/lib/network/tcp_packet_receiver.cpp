@@ -86,6 +86,7 @@ bool TCPPacketReceiver::processSocket(bool expectingPacket)
 	}
 
 	TCPPacket* pReceiveWindow = TCPPacket::ObjPool().createObject();
+	const int recvSize = (int)(pReceiveWindow->size() - pReceiveWindow->wpos());
 	int len = pReceiveWindow->recvFromEndPoint(*pEndpoint_);
 
 	if (len < 0)
@@ -111,12 +112,29 @@ bool TCPPacketReceiver::processSocket(bool expectingPacket)
 		return false;
 	}
 	
+	++numRecvPackets_;
+
 	Reason ret = this->processPacket(pChannel, pReceiveWindow);
 
 	if(ret != REASON_SUCCESS)
 		this->dispatcher().errorReporter().reportException(ret, pEndpoint_->addr());
 	
-	return true;
+	// ûմ˵socketѾգ recvһεõEAGAIN
+	return len >= recvSize;
+}
+
+//-------------------------------------------------------------------------------------
+uint32 TCPPacketReceiver::recvPacketsLimit()
+{
+	// ԵʱһζEAGAIN ʣݲٱ֪ͨ
+	if(g_pollerEdgeTriggered)
+		return 0;
+
+	Channel* pChannel = pNetworkInterface_->findChannel(pEndpoint_->addr());
+	if(pChannel && pChannel->isInternal())
+		return g_intReceivePacketsLimit;
+
+	return g_extReceivePacketsLimit;
 }
 
 //-------------------------------------------------------------------------------------
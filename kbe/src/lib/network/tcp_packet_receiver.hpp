@@ -57,6 +57,7 @@ public:
 protected:
 	bool processSocket(bool expectingPacket);
 	PacketReceiver::RecvState checkSocketErrors(int len, bool expectingPacket);
+	uint32 recvPacketsLimit();
 	
 };
 }
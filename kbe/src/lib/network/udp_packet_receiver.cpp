@@ -32,6 +32,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "network/network_interface.hpp"
 #include "network/event_poller.hpp"
 #include "network/error_reporter.hpp"
+#include "network/reliable_udp_filter.hpp"
 
 namespace KBEngine { 
 namespace Mercury
@@ -59,16 +60,35 @@ UDPPacketReceiver::SmartPoolObjectPtr UDPPacketReceiver::createSmartPoolObj()
 	return SmartPoolObjectPtr(new SmartPoolObject<UDPPacketReceiver>(ObjPool().createObject(), _g_objPool));
 }
 
+//-------------------------------------------------------------------------------------
+UDPPacketReceiver::UDPPacketReceiver() :
+	PacketReceiver()
+{
+#if defined(__linux__)
+	memset(recvPackets_, 0, sizeof(recvPackets_));
+#endif
+}
+
 //-------------------------------------------------------------------------------------
 UDPPacketReceiver::UDPPacketReceiver(EndPoint & endpoint,
 	   NetworkInterface & networkInterface	) :
 	PacketReceiver(endpoint, networkInterface)
 {
+#if defined(__linux__)
+	memset(recvPackets_, 0, sizeof(recvPackets_));
+#endif
 }
 
 //-------------------------------------------------------------------------------------
 UDPPacketReceiver::~UDPPacketReceiver()
 {
+#if defined(__linux__)
+	for(int i = 0; i < RECV_BATCH_SIZE; ++i)
+	{
+		if(recvPackets_[i])
+			UDPPacket::ObjPool().reclaimObject(recvPackets_[i]);
+	}
+#endif
 }
 
 
@@ -77,7 +97,54 @@ bool UDPPacketReceiver::processSocket(bool expectingPacket)
 {
 //	Channel* pChannel = networkInterface_.findChannel(endpoint_.addr());
 //	KBE_ASSERT(pChannel != NULL);
-	
+
+#if defined(__linux__)
+	struct mmsghdr msgs[RECV_BATCH_SIZE];
+	struct iovec iovs[RECV_BATCH_SIZE];
+	struct sockaddr_in addrs[RECV_BATCH_SIZE];
+
+	memset(msgs, 0, sizeof(msgs));
+
+	for(int i = 0; i < RECV_BATCH_SIZE; ++i)
+	{
+		if(recvPackets_[i] == NULL)
+			recvPackets_[i] = UDPPacket::ObjPool().createObject();
+
+		UDPPacket* pPacket = recvPackets_[i];
+		iovs[i].iov_base = pPacket->data() + pPacket->wpos();
+		iovs[i].iov_len = pPacket->size() - pPacket->wpos();
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+	}
+
+	int count = pEndpoint_->recvmmsg(msgs, RECV_BATCH_SIZE);
+
+	if (count <= 0)
+	{
+		PacketReceiver::RecvState rstate = this->checkSocketErrors(count, expectingPacket);
+		return rstate == PacketReceiver::RECV_STATE_CONTINUE;
+	}
+
+	for(int i = 0; i < count; ++i)
+	{
+		// յݱֱӺԣ ԭλ´μʹ
+		if(msgs[i].msg_len == 0)
+			continue;
+
+		UDPPacket* pPacket = recvPackets_[i];
+		recvPackets_[i] = NULL;
+		pPacket->wpos(pPacket->wpos() + msgs[i].msg_len);
+		++numRecvPackets_;
+
+		// ʧֻݱԴйأ ʣݱͻˣ 
+		this->processRecvPacket(pPacket, Address(addrs[i].sin_addr.s_addr, addrs[i].sin_port));
+	}
+
+	// ֮жϣ յݱһ˵socketѾ
+	return count == RECV_BATCH_SIZE;
+#else
 	Address	srcAddr;
 	UDPPacket* pChannelReceiveWindow = UDPPacket::ObjPool().createObject();
 	int len = pChannelReceiveWindow->recvFromEndPoint(*pEndpoint_, &srcAddr);
@@ -89,6 +156,34 @@ bool UDPPacketReceiver::processSocket(bool expectingPacket)
 		return rstate == PacketReceiver::RECV_STATE_CONTINUE;
 	}
 	
+	++numRecvPackets_;
+	return this->processRecvPacket(pChannelReceiveWindow, srcAddr);
+#endif
+}
+
+//-------------------------------------------------------------------------------------
+int UDPPacketReceiver::handleInputNotification(int fd)
+{
+	sourceRecvCounts_.clear();
+	return PacketReceiver::handleInputNotification(fd);
+}
+
+//-------------------------------------------------------------------------------------
+uint32 UDPPacketReceiver::recvPacketsLimit()
+{
+	return RECV_PACKETS_LIMIT;
+}
+
+//-------------------------------------------------------------------------------------
+bool UDPPacketReceiver::processRecvPacket(UDPPacket* pChannelReceiveWindow, const Address& srcAddr)
+{
+	// Դ޺󱾴֪ͨڵʣݱ һͻռsocketĶȡ
+	if(g_extReceivePacketsLimit > 0 && ++sourceRecvCounts_[srcAddr] > g_extReceivePacketsLimit)
+	{
+		UDPPacket::ObjPool().reclaimObject(pChannelReceiveWindow);
+		return true;
+	}
+
 	Channel* pSrcChannel = pNetworkInterface_->findChannel(srcAddr);
 
 	if(pSrcChannel == NULL) 
@@ -105,6 +200,8 @@ bool UDPPacketReceiver::processSocket(bool expectingPacket)
 			pSrcChannel->destroy();
 			return false;
 		}
+
+		installReliableUDPFilter(pSrcChannel);
 	}
 	
 	KBE_ASSERT(pSrcChannel != NULL);
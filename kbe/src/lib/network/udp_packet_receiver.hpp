@@ -26,6 +26,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "cstdkbe/objectpool.hpp"
 #include "helper/debug_helper.hpp"
 #include "network/common.hpp"
+#include "network/address.hpp"
 #include "network/interfaces.hpp"
 #include "network/udp_packet.hpp"
 #include "network/packet_receiver.hpp"
@@ -47,17 +48,37 @@ public:
 	static ObjectPool<UDPPacketReceiver>& ObjPool();
 	static void destroyObjPool();
 
-	UDPPacketReceiver():PacketReceiver(){}
+	UDPPacketReceiver();
 	UDPPacketReceiver(EndPoint & endpoint, NetworkInterface & networkInterface);
 	~UDPPacketReceiver();
 
 	Reason processFilteredPacket(Channel* pChannel, Packet * pPacket);
+
+	virtual int handleInputNotification(int fd);
 	
 protected:
+	/**
+		ⲿUDPͨһsocket ͨްԴ ֻһ֪ͨڵ
+	*/
+	uint32 recvPacketsLimit();
+
 	bool processSocket(bool expectingPacket);
+	bool processRecvPacket(UDPPacket* pPacket, const Address& srcAddr);
 	PacketReceiver::RecvState checkSocketErrors(int len, bool expectingPacket);
 protected:
+#if defined(__linux__)
+	// recvmmsgһȡݱ
+	enum { RECV_BATCH_SIZE = 16 };
+
+	// ԤȷõĽհ ȡߵλһνǰ
+	UDPPacket* recvPackets_[RECV_BATCH_SIZE];
+#endif
+
+	// һοɶ֪ͨԴϼȡݱ
+	enum { RECV_PACKETS_LIMIT = 1024 };
 
+	// οɶ֪ͨÿԴѾȡݱ
+	std::map<Address, uint32> sourceRecvCounts_;
 };
 
 }
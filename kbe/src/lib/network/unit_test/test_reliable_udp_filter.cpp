@@ -0,0 +1,380 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2012 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+	ɿUDPĻز
+	ReliableUDPFilter˵ͨһģ·෢ͣ ·̶ӳʹ
+	ɿϢȫ˳򽻸ֻһΣ ɿϢŵҲԽ֮ǰĿɿϢ
+*/
+
+#include "network/reliable_udp_filter.hpp"
+#include "network/bundle.hpp"
+#include "network/udp_packet.hpp"
+#include "network/packet_receiver.hpp"
+#include "network/event_dispatcher.hpp"
+#include "network/network_interface.hpp"
+
+using namespace KBEngine;
+using namespace KBEngine::Mercury;
+
+static int g_numFailures = 0;
+
+#define TEST_CHECK(cond)																\
+	if(!(cond))																			\
+	{																					\
+		printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);				\
+		++g_numFailures;																\
+	}
+
+// Ϣͣ ÿ԰ݵĵһֽ
+enum
+{
+	MSG_RELIABLE = 1,
+	MSG_UNRELIABLE = 2
+};
+
+// ÿϢ͵ļʱ()
+#define TEST_SEND_INTERVAL				2
+#define TEST_MAX_DURATION				120000
+
+class TestLink;
+
+/*
+	¼ϲյϢ
+*/
+class TestReceiver : public PacketReceiver
+{
+public:
+	TestReceiver():
+	  PacketReceiver(),
+	  reliableMsgs(),
+	  unreliableMsgs(),
+	  unreliableOutOfOrder(0)
+	{
+	}
+
+	virtual Reason processFilteredPacket(Channel* pChannel, Packet * pPacket)
+	{
+		uint8 type;
+		uint32 sn, reliableSent;
+
+		(*pPacket) >> type;
+		(*pPacket) >> sn;
+		(*pPacket) >> reliableSent;
+
+		if(type == MSG_RELIABLE)
+		{
+			reliableMsgs.push_back(sn);
+		}
+		else
+		{
+			// ɿϢڷ֮ǰĿɿϢȫ֮ܽ
+			if(reliableMsgs.size() < reliableSent)
+				++unreliableOutOfOrder;
+
+			unreliableMsgs.push_back(sn);
+		}
+
+		UDPPacket::ObjPool().reclaimObject(static_cast<UDPPacket*>(pPacket));
+		return REASON_SUCCESS;
+	}
+
+	std::vector<uint32> reliableMsgs;
+	std::vector<uint32> unreliableMsgs;
+	uint32 unreliableOutOfOrder;
+
+protected:
+	virtual bool processSocket(bool expectingPacket){ return false; }
+	virtual RecvState checkSocketErrors(int len, bool expectingPacket){ return RECV_STATE_BREAK; }
+};
+
+/*
+	Զ˵㣬 ͵İģ· ʱ·
+*/
+class TestFilter : public ReliableUDPFilter
+{
+public:
+	TestFilter(TestLink& link, int side):
+	  ReliableUDPFilter(NULL),
+	  link_(link),
+	  side_(side)
+	{
+	}
+
+	void update(uint32 now){ flush(now); }
+	bool idle() const { return sndBuf_.empty(); }
+
+protected:
+	virtual void sendSegment(UDPPacket* pPacket);
+	virtual void onPendingData(){}
+	virtual uint32 currentTime() const;
+
+	TestLink& link_;
+	int side_;
+};
+
+/*
+	ģ· lossRate(ٷֱ) ÿӳbaseDelaybaseDelay + jitter󵽴
+*/
+class TestLink
+{
+public:
+	struct Datagram
+	{
+		uint32 arriveTime;
+		int dest;
+		std::string datas;
+	};
+
+	TestLink(uint32 lossRate, uint32 baseDelay, uint32 jitter):
+	  now(1),
+	  lossRate_(lossRate),
+	  baseDelay_(baseDelay),
+	  jitter_(jitter),
+	  seed_(12345),
+	  inflight_(),
+	  numSent(0),
+	  numDropped(0)
+	{
+		pFilters[0] = pFilters[1] = NULL;
+	}
+
+	void push(int side, UDPPacket* pPacket)
+	{
+		++numSent;
+
+		if(nextRandom() % 100 < lossRate_)
+		{
+			++numDropped;
+			return;
+		}
+
+		Datagram datagram;
+		datagram.arriveTime = now + baseDelay_ + (jitter_ > 0 ? nextRandom() % (jitter_ + 1) : 0);
+		datagram.dest = 1 - side;
+		datagram.datas.assign((const char*)pPacket->data() + pPacket->rpos(), pPacket->totalSize());
+		inflight_.push_back(datagram);
+	}
+
+	/**
+		ƽһ룬 İԶ
+	*/
+	void step(TestReceiver* pReceivers)
+	{
+		++now;
+
+		std::vector<Datagram> arrived;
+		std::vector<Datagram>::iterator iter = inflight_.begin();
+		while(iter != inflight_.end())
+		{
+			if((int32)(now - iter->arriveTime) >= 0)
+			{
+				arrived.push_back(*iter);
+				iter = inflight_.erase(iter);
+			}
+			else
+			{
+				++iter;
+			}
+		}
+
+		for(size_t i = 0; i < arrived.size(); ++i)
+		{
+			UDPPacket* pPacket = UDPPacket::ObjPool().createObject();
+			pPacket->append(arrived[i].datas.data(), arrived[i].datas.size());
+			pFilters[arrived[i].dest]->recv(NULL, pReceivers[arrived[i].dest], pPacket);
+		}
+	}
+
+	bool empty() const { return inflight_.empty(); }
+
+	uint32 now;
+	TestFilter* pFilters[2];
+
+private:
+	// ̶ӵͬ࣬ ÿеĶͬ
+	uint32 nextRandom()
+	{
+		seed_ = seed_ * 1103515245 + 12345;
+		return (seed_ >> 16) & 0x7fff;
+	}
+
+	uint32 lossRate_;
+	uint32 baseDelay_;
+	uint32 jitter_;
+	uint32 seed_;
+	std::vector<Datagram> inflight_;
+
+public:
+	uint32 numSent;
+	uint32 numDropped;
+};
+
+//-------------------------------------------------------------------------------------
+void TestFilter::sendSegment(UDPPacket* pPacket)
+{
+	link_.push(side_, pPacket);
+}
+
+//-------------------------------------------------------------------------------------
+uint32 TestFilter::currentTime() const
+{
+	return link_.now;
+}
+
+//-------------------------------------------------------------------------------------
+static void sendMessage(NetworkInterface& networkInterface, TestFilter& filter, Bundle* pBundle,
+	uint8 type, uint32 sn, uint32 reliableSent)
+{
+	UDPPacket* pPacket = UDPPacket::ObjPool().createObject();
+	(*pPacket) << type;
+	(*pPacket) << sn;
+	(*pPacket) << reliableSent;
+	pPacket->pBundle(pBundle);
+
+	filter.send(networkInterface, NULL, pPacket);
+
+	pPacket->pBundle(NULL);
+	UDPPacket::ObjPool().reclaimObject(pPacket);
+}
+
+//-------------------------------------------------------------------------------------
+static void testDelivery(NetworkInterface& networkInterface, uint32 lossRate, uint32 jitter, uint32 numMessages)
+{
+	printf("testDelivery: lossRate=%u%%, jitter=%ums, messages=%u\n", lossRate, jitter, numMessages);
+
+	TestLink link(lossRate, 5, jitter);
+	TestReceiver receivers[2];
+
+	// ˶зͣ ȷϼȿЯҲԵ
+	TestFilter* pFilter0 = new TestFilter(link, 0);
+	TestFilter* pFilter1 = new TestFilter(link, 1);
+	PacketFilterPtr filterPtr0(pFilter0);
+	PacketFilterPtr filterPtr1(pFilter1);
+	link.pFilters[0] = pFilter0;
+	link.pFilters[1] = pFilter1;
+
+	// ҲҪɿbundle߲ɿͨ
+	Bundle unreliableBundle(NULL, PROTOCOL_UDP);
+	unreliableBundle.reliable(false);
+
+	uint32 reliableSent = 0, unreliableSent = 0;
+
+	while(link.now < TEST_MAX_DURATION)
+	{
+		if(reliableSent < numMessages && link.now % TEST_SEND_INTERVAL == 0)
+		{
+			sendMessage(networkInterface, *pFilter0, NULL, MSG_RELIABLE, reliableSent, 0);
+			++reliableSent;
+
+			sendMessage(networkInterface, *pFilter0, &unreliableBundle, MSG_UNRELIABLE,
+				unreliableSent++, reliableSent);
+
+			sendMessage(networkInterface, *pFilter1, NULL, MSG_RELIABLE, reliableSent - 1, 0);
+		}
+
+		link.step(receivers);
+
+		if(link.now % RELIABLE_UDP_INTERVAL == 0)
+		{
+			pFilter0->update(link.now);
+			pFilter1->update(link.now);
+		}
+
+		if(reliableSent == numMessages && pFilter0->idle() && pFilter1->idle() && link.empty())
+			break;
+	}
+
+	TEST_CHECK(pFilter0->idle() && pFilter1->idle());
+
+	// ɿͨкֻͲɿϢ 򵽴Ĺڰ ఴŽ
+	uint32 unreliableOnlyStart = unreliableSent;
+	uint32 endTime = link.now + numMessages * TEST_SEND_INTERVAL;
+
+	while(link.now < endTime || !link.empty())
+	{
+		if(link.now < endTime && link.now % TEST_SEND_INTERVAL == 0)
+		{
+			sendMessage(networkInterface, *pFilter0, &unreliableBundle, MSG_UNRELIABLE,
+				unreliableSent++, reliableSent);
+		}
+
+		link.step(receivers);
+	}
+
+	// ɿϢȫ Ұ˳ֻһ
+	for(int side = 0; side < 2; ++side)
+	{
+		std::vector<uint32>& msgs = receivers[side].reliableMsgs;
+		TEST_CHECK(msgs.size() == numMessages);
+
+		for(uint32 i = 0; i < msgs.size(); ++i)
+		{
+			TEST_CHECK(msgs[i] == i);
+			if(msgs[i] != i)
+				break;
+		}
+	}
+
+	// ɿϢŵ Խ֮ǰĿɿϢ
+	std::vector<uint32>& unreliableMsgs = receivers[1].unreliableMsgs;
+	TEST_CHECK(unreliableMsgs.size() > 0);
+	TEST_CHECK(receivers[1].unreliableOutOfOrder == 0);
+	TEST_CHECK(!unreliableMsgs.empty() && unreliableMsgs.back() >= unreliableOnlyStart);
+
+	for(uint32 i = 1; i < unreliableMsgs.size(); ++i)
+	{
+		TEST_CHECK(unreliableMsgs[i] > unreliableMsgs[i - 1]);
+		if(unreliableMsgs[i] <= unreliableMsgs[i - 1])
+			break;
+	}
+
+	if(lossRate > 0)
+	{
+		TEST_CHECK(link.numDropped > 0);
+		TEST_CHECK(pFilter0->numRetransmits() > 0);
+	}
+
+	printf("\tsent=%u, dropped=%u, retransmits=%u/%u, unreliable delivered=%u/%u, time=%ums\n",
+		link.numSent, link.numDropped, pFilter0->numRetransmits(), pFilter1->numRetransmits(),
+		(uint32)unreliableMsgs.size(), unreliableSent, link.now);
+}
+
+//-------------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+	// ֻڷTCPʱʹӿڣ ֻҪһЧĶ
+	EventDispatcher dispatcher;
+	NetworkInterface networkInterface(&dispatcher);
+
+	testDelivery(networkInterface, 0, 0, 500);
+	testDelivery(networkInterface, 0, 20, 500);
+	testDelivery(networkInterface, 10, 20, 2000);
+	testDelivery(networkInterface, 30, 40, 1000);
+
+	if(g_numFailures > 0)
+	{
+		printf("FAILED: %d check(s) failed.\n", g_numFailures);
+		return 1;
+	}
+
+	printf("OK\n");
+	return 0;
+}
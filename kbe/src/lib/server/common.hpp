@@ -59,6 +59,11 @@ namespace KBEngine {
 	SENDBUNDLE.newMessage(BaseappInterface::forwardMessageToClientFromCellapp);															\
 	SENDBUNDLE << ENTITYID;																												\
 
+// cellappתױϢͻ˿ʼ ɿUDP¶ʧش
+#define MERCURY_ENTITY_MESSAGE_FORWARD_CLIENT_VOLATILE_START(ENTITYID, SENDBUNDLE)														\
+	SENDBUNDLE.newMessage(BaseappInterface::forwardVolatileMessageToClientFromCellapp);												\
+	SENDBUNDLE << ENTITYID;																												\
+
 // cellappתϢͻϢ׷Ϣ
 #define MERCURY_ENTITY_MESSAGE_FORWARD_CLIENT_APPEND(SENDBUNDLE, FORWARDBUNDLE)															\
 	FORWARDBUNDLE.finish(true);																											\
@@ -303,11 +303,52 @@ bool ServerConfig::loadConfig(std::string fileName)
 			}
 		};
 
+		childnode = xml->enterNode(rootNode, "receivePacketsLimit");
+		if(childnode)
+		{
+			TiXmlNode* childnode1 = xml->enterNode(childnode, "internal");
+			if(childnode1)
+				Mercury::g_intReceivePacketsLimit = KBE_MAX(0, xml->getValInt(childnode1));
+
+			childnode1 = xml->enterNode(childnode, "external");
+			if(childnode1)
+				Mercury::g_extReceivePacketsLimit = KBE_MAX(0, xml->getValInt(childnode1));
+		}
+
+		childnode = xml->enterNode(rootNode, "poller");
+		if(childnode)
+		{
+			TiXmlNode* childnode1 = xml->enterNode(childnode, "maxEvents");
+			if(childnode1)
+				Mercury::g_pollerMaxEvents = KBE_MAX(1, xml->getValInt(childnode1));
+
+			childnode1 = xml->enterNode(childnode, "edgeTriggered");
+			if(childnode1)
+				Mercury::g_pollerEdgeTriggered = (xml->getValStr(childnode1) == "true");
+		}
+
+		childnode = xml->enterNode(rootNode, "reliableUDP");
+		if(childnode)
+		{
+			TiXmlNode* childnode1 = xml->enterNode(childnode, "external");
+			if(childnode1)
+				Mercury::g_extReliableUDP = (xml->getValStr(childnode1) == "true");
+		}
+
 		childnode = xml->enterNode(rootNode, "encrypt_type");
 		if(childnode)
 		{
 			Mercury::g_channelExternalEncryptType = xml->getValInt(childnode);
 		}
+
+		// ܹ滻ͨϵĿɿUDP ߲ͬʱʹ
+		if(Mercury::g_extReliableUDP && Mercury::g_channelExternalEncryptType > 0)
+		{
+			ERROR_MSG(boost::format("ServerConfig::loadConfig: reliableUDP/external can't be used with encrypt_type(%1%), "
+				"reliableUDP is disabled!\n") % (int)Mercury::g_channelExternalEncryptType);
+
+			Mercury::g_extReliableUDP = false;
+		}
 	}
 
 	rootNode = xml->getRootNode("gameUpdateHertz");
@@ -514,6 +555,31 @@ bool ServerConfig::loadConfig(std::string fileName)
 				_cellAppInfo.coordinateSystem_hasY = (xml->getValStr(childnode) == "true");
 			}
 
+			childnode = xml->enterNode(node, "grid");
+			if(childnode)
+			{
+				TiXmlNode* gridnode = xml->enterNode(childnode, "enable");
+				if(gridnode)
+				{
+					_cellAppInfo.coordinateSystem_useGrid = (xml->getValStr(gridnode) == "true");
+				}
+
+				gridnode = xml->enterNode(childnode, "size");
+				if(gridnode)
+				{
+					_cellAppInfo.coordinateSystem_gridSize = (float)xml->getValFloat(gridnode);
+
+					if(_cellAppInfo.coordinateSystem_gridSize <= 0.f)
+						_cellAppInfo.coordinateSystem_gridSize = 100.f;
+				}
+			}
+
+			childnode = xml->enterNode(node, "deferred_update");
+			if(childnode)
+			{
+				_cellAppInfo.coordinateSystem_deferredUpdate = (xml->getValStr(childnode) == "true");
+			}
+
 			childnode = xml->enterNode(node, "entity_posdir_additional_updates");
 			if(childnode)
 			{
@@ -778,6 +844,22 @@ bool ServerConfig::loadConfig(std::string fileName)
 		if(node != NULL)
 			_dbmgrInfo.db_numConnections = xml->getValInt(node);
 		
+		node = xml->enterNode(rootNode, "batchWrite");
+		if(node != NULL)
+		{
+			TiXmlNode* childnode = xml->enterNode(node, "maxEntities");
+			if(childnode)
+				_dbmgrInfo.db_batchWriteMaxEntities = KBE_MAX(0, xml->getValInt(childnode));
+
+			childnode = xml->enterNode(node, "maxLatency");
+			if(childnode)
+				_dbmgrInfo.db_batchWriteMaxLatency = KBE_MAX(0, xml->getValInt(childnode));
+		}
+
+		node = xml->enterNode(rootNode, "coalesceWrites");
+		if(node != NULL)
+			_dbmgrInfo.db_coalesceWrites = (xml->getValStr(node) == "true");
+
 		node = xml->enterNode(rootNode, "unicodeString");
 		if(node != NULL)
 		{
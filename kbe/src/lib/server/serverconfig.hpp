@@ -111,8 +111,15 @@ typedef struct EngineComponentInfo
 		notFoundAccountAutoCreate = false;
 		account_registration_enable = false;
 		use_coordinate_system = true;
+		coordinateSystem_hasY = false;
+		coordinateSystem_useGrid = false;
+		coordinateSystem_gridSize = 100.f;
+		coordinateSystem_deferredUpdate = false;
 		account_type = 3;
 		debugDBMgr = false;
+		db_batchWriteMaxEntities = 64;
+		db_batchWriteMaxLatency = 50;
+		db_coalesceWrites = false;
 
 		externalAddress[0] = '\0';
 	}
@@ -139,6 +146,9 @@ typedef struct EngineComponentInfo
 	
 	bool use_coordinate_system;								// Ƿʹϵͳ Ϊfalse aoi,trap, moveȹܽά
 	bool coordinateSystem_hasY;								// ΧǹYᣬ עyaoitrapȹ˸߶ȣ yĹһ
+	bool coordinateSystem_useGrid;							// ϵͳʹþ ʵܼʱaoitrapȸ¿ֻڽʵ
+	float coordinateSystem_gridSize;						// ı߳
+	bool coordinateSystem_deferredUpdate;					// ʵıʱϵͳ ÿtickͳһһ
 	uint16 entity_posdir_additional_updates;				// ʵλֹͣıͻ˸tickελϢΪ0Ǹ¡
 
 	bool aliasEntityID;										// ŻEntityIDaoiΧС255EntityID, 䵽clientʱʹ1ֽαID 
@@ -157,6 +167,9 @@ typedef struct EngineComponentInfo
 	char db_password[MAX_BUF * 10];							// ݿ
 	char db_name[MAX_NAME];									// ݿ
 	uint16 db_numConnections;								// ݿ
+	uint32 db_batchWriteMaxEntities;						// дentityÿ Сڵ1Ϊر
+	uint32 db_batchWriteMaxLatency;							// дentityȴúύ()
+	bool db_coalesceWrites;									// ͬһentityŶедǷϲ
 	std::string db_unicodeString_characterSet;				// ݿַ
 	std::string db_unicodeString_collation;
 	bool notFoundAccountAutoCreate;							// ¼ϷʱϷݿҲϷ˺Զ
@@ -51,6 +51,43 @@ void setMainThreadIdleFunctions( void (*pStartFunc)(), void (*pEndFunc)() )
 	pMainThreadIdleEndFunc = pEndFunc;
 }
 
+/**
+	ԭӼӣ ֮ǰֵ
+*/
+inline long atomicAdd(volatile long* pValue, long v)
+{
+#if KBE_PLATFORM == PLATFORM_WIN32
+	return ::InterlockedExchangeAdd(pValue, v);
+#else
+	return __sync_fetch_and_add(pValue, v);
+#endif
+}
+
+/**
+	ԭӱȽϽָ룬 *pDestcomparandʱдexchange *pDestԭֵ
+*/
+inline void* atomicCompareExchangePointer(void* volatile* pDest, void* exchange, void* comparand)
+{
+#if KBE_PLATFORM == PLATFORM_WIN32
+	return ::InterlockedCompareExchangePointer(pDest, exchange, comparand);
+#else
+	return __sync_val_compare_and_swap(pDest, comparand, exchange);
+#endif
+}
+
+/**
+	ԭӽָ룬 *pDestԭֵ
+*/
+inline void* atomicExchangePointer(void* volatile* pDest, void* exchange)
+{
+#if KBE_PLATFORM == PLATFORM_WIN32
+	return ::InterlockedExchangePointer(pDest, exchange);
+#else
+	__sync_synchronize();
+	return __sync_lock_test_and_set(pDest, exchange);
+#endif
+}
+
 }
 
 }
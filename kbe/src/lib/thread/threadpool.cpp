@@ -97,15 +97,82 @@ bool TPThread::join(void)
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+TPLatencyHistogram::TPLatencyHistogram():
+count_(0)
+{
+	for(int i = 0; i < NUM_BUCKETS; i++)
+		buckets_[i] = 0;
+}
+
+//-------------------------------------------------------------------------------------
+void TPLatencyHistogram::add(uint64 stamps)
+{
+	uint64 us = (uint64)(stamps / stampsPerSecondD() * 1000000.0);
+
+	int idx = 0;
+	while(us > 0 && idx < NUM_BUCKETS - 1)
+	{
+		us >>= 1;
+		++idx;
+	}
+
+	KBEConcurrency::atomicAdd(&buckets_[idx], 1);
+	KBEConcurrency::atomicAdd(&count_, 1);
+}
+
+//-------------------------------------------------------------------------------------
+uint64 TPLatencyHistogram::percentile(uint32 rank)const
+{
+	uint32 n = 0;
+	for(int i = 0; i < NUM_BUCKETS; i++)
+	{
+		n += (uint32)buckets_[i];
+		if(n >= rank)
+			return (uint64)1 << i;
+	}
+
+	return (uint64)1 << (NUM_BUCKETS - 1);
+}
+
+//-------------------------------------------------------------------------------------
+std::string TPLatencyHistogram::print()const
+{
+	uint32 n = count();
+	if(n == 0)
+		return "count=0";
+
+	std::string ret = (boost::format("count=%1%, p50<%2%us, p90<%3%us, p99<%4%us, [") % n % 
+		percentile((n + 1) / 2) % percentile((uint32)(n * 0.9)) % percentile((uint32)(n * 0.99))).str();
+
+	for(int i = 0; i < NUM_BUCKETS; i++)
+	{
+		if(buckets_[i] == 0)
+			continue;
+
+		if(i == NUM_BUCKETS - 1)
+			ret += (boost::format(">=%1%us:%2%, ") % ((uint64)1 << (i - 1)) % buckets_[i]).str();
+		else
+			ret += (boost::format("<%1%us:%2%, ") % ((uint64)1 << i) % buckets_[i]).str();
+	}
+
+	ret += "]";
+	return ret;
+}
+
 //-------------------------------------------------------------------------------------
 ThreadPool::ThreadPool():
 isInitialize_(false),
-bufferedTaskList_(),
+taskDeques_(),
+bufferedTaskCount_(0),
+nextTaskDeque_(0),
+nextHomeDeque_(0),
+finiTaskQueue_(NULL),
 finiTaskList_(),
 finiTaskList_count_(0),
-bufferedTaskList_mutex_(),
 threadStateList_mutex_(),
-finiTaskList_mutex_(),
+queueTimeHistogram_(),
+execTimeHistogram_(),
 busyThreadList_(),
 freeThreadList_(),
 allThreadList_(),
@@ -117,8 +184,6 @@ normalThreadCount_(0),
 isDestroyed_(false)
 {		
 	THREAD_MUTEX_INIT(threadStateList_mutex_);	
-	THREAD_MUTEX_INIT(bufferedTaskList_mutex_);
-	THREAD_MUTEX_INIT(finiTaskList_mutex_);
 }
 
 //-------------------------------------------------------------------------------------
@@ -137,6 +202,8 @@ bool ThreadPool::initializeWatcher()
 	WATCH_OBJECT((boost::format("%1%/bufferedTaskSize") % name()).str().c_str(), this, &ThreadPool::bufferTaskSize);
 	WATCH_OBJECT((boost::format("%1%/finiTaskSize") % name()).str().c_str(), this, &ThreadPool::finiTaskSize);
 	WATCH_OBJECT((boost::format("%1%/busyThreadStates") % name()).str().c_str(), this, &ThreadPool::printThreadWorks);
+	WATCH_OBJECT((boost::format("%1%/queueTimes") % name()).str().c_str(), this, &ThreadPool::printQueueTimes);
+	WATCH_OBJECT((boost::format("%1%/execTimes") % name()).str().c_str(), this, &ThreadPool::printExecTimes);
 	return true;
 }
 
@@ -231,8 +298,8 @@ void ThreadPool::destroy()
 	allThreadList_.clear();
 	THREAD_MUTEX_UNLOCK(threadStateList_mutex_);
 
-	THREAD_MUTEX_LOCK(finiTaskList_mutex_);
-	
+	takeFiniTasks();
+
 	if(finiTaskList_.size() > 0)
 	{
 		WARNING_MSG(boost::format("ThreadPool::~ThreadPool(): Discarding %1% finished tasks.\n") % 
@@ -248,44 +315,77 @@ void ThreadPool::destroy()
 		finiTaskList_count_ = 0;
 	}
 
-	THREAD_MUTEX_UNLOCK(finiTaskList_mutex_);
+	clearTaskDeques();
 
-	THREAD_MUTEX_LOCK(bufferedTaskList_mutex_);
+	THREAD_MUTEX_DELETE(threadStateList_mutex_);
 
-	if(bufferedTaskList_.size() > 0)
-	{
-		WARNING_MSG(boost::format("ThreadPool::~ThreadPool(): Discarding %1% buffered tasks.\n") % 
-			bufferedTaskList_.size());
+	DEBUG_MSG("ThreadPool::destroy(): successfully!\n");
+}
+
+//-------------------------------------------------------------------------------------
+void ThreadPool::clearTaskDeques()
+{
+	size_t count = 0;
 
-		while(bufferedTaskList_.size() > 0)
+	std::vector<TaskDeque*>::iterator iter = taskDeques_.begin();
+	for(; iter != taskDeques_.end(); iter++)
+	{
+		std::deque<TPTask*>::iterator taskIter = (*iter)->tasks.begin();
+		for(; taskIter != (*iter)->tasks.end(); taskIter++)
 		{
-			TPTask* tptask = bufferedTaskList_.front();
-			bufferedTaskList_.pop();
-			delete tptask;
+			delete (*taskIter);
+			++count;
 		}
+
+		THREAD_MUTEX_DELETE((*iter)->mutex);
+		delete (*iter);
 	}
-	
-	THREAD_MUTEX_UNLOCK(bufferedTaskList_mutex_);
 
-	THREAD_MUTEX_DELETE(threadStateList_mutex_);
-	THREAD_MUTEX_DELETE(bufferedTaskList_mutex_);
-	THREAD_MUTEX_DELETE(finiTaskList_mutex_);
+	if(count > 0)
+	{
+		WARNING_MSG(boost::format("ThreadPool::~ThreadPool(): Discarding %1% buffered tasks.\n") % 
+			count);
+	}
 
-	DEBUG_MSG("ThreadPool::destroy(): successfully!\n");
+	taskDeques_.clear();
+	bufferedTaskCount_ = 0;
+}
+
+//-------------------------------------------------------------------------------------
+void ThreadPool::assignHomeDeque(TPThread* tptd)
+{
+	tptd->homeDeque_ = nextHomeDeque_++ % taskDeques_.size();
 }
 
 //-------------------------------------------------------------------------------------
-TPTask* ThreadPool::popbufferTask(void)
+TPTask* ThreadPool::popbufferTask(uint32 homeDeque)
 {
+	// ʱжǿյģ 
+	if(bufferedTaskCount_ <= 0 || taskDeques_.size() == 0)
+		return NULL;
+
 	TPTask* tptask = NULL;
-	THREAD_MUTEX_LOCK(bufferedTaskList_mutex_);
+	size_t ndeques = taskDeques_.size();
 
-	size_t size = bufferedTaskList_.size();
-	if(size > 0)
+	for(size_t i = 0; i < ndeques && tptask == NULL; i++)
 	{
-		tptask = bufferedTaskList_.front();
-		bufferedTaskList_.pop();
-	
+		TaskDeque* pDeque = taskDeques_[(homeDeque + i) % ndeques];
+
+		THREAD_MUTEX_LOCK(pDeque->mutex);
+
+		// ȡʱҲͷȡ е˿ѯʱŶӵȱ߳ȡߣ Ƚȳ
+		if(pDeque->tasks.size() > 0)
+		{
+			tptask = pDeque->tasks.front();
+			pDeque->tasks.pop_front();
+		}
+
+		THREAD_MUTEX_UNLOCK(pDeque->mutex);
+	}
+
+	if(tptask)
+	{
+		long size = KBEConcurrency::atomicAdd(&bufferedTaskCount_, -1);
 		if(size > THREAD_BUSY_SIZE)
 		{
 			WARNING_MSG(boost::format("ThreadPool::popbufferTask: task buffered(%1%)!\n") % 
@@ -293,18 +393,37 @@ TPTask* ThreadPool::popbufferTask(void)
 		}
 	}
 
-	THREAD_MUTEX_UNLOCK(bufferedTaskList_mutex_);	
-
 	return tptask;
 }
 
 //-------------------------------------------------------------------------------------
 void ThreadPool::addFiniTask(TPTask* tptask)
 { 
-	THREAD_MUTEX_LOCK(finiTaskList_mutex_);
-	finiTaskList_.push_back(tptask); 
-	++finiTaskList_count_;
-	THREAD_MUTEX_UNLOCK(finiTaskList_mutex_);	
+	// ߳룬 ֻ߳һȡ ABA
+	TPTask* pHead = NULL;
+
+	do
+	{
+		pHead = finiTaskQueue_;
+		tptask->pNextFiniTask_ = pHead;
+	}
+	while(KBEConcurrency::atomicCompareExchangePointer((void* volatile*)&finiTaskQueue_, 
+		tptask, pHead) != pHead);
+
+	KBEConcurrency::atomicAdd(&finiTaskList_count_, 1);
+}
+
+//-------------------------------------------------------------------------------------
+void ThreadPool::onTaskProcessed(TPTask* tptask, uint64 startTime, uint64 endTime)
+{
+	// ֱӽִеûŶ
+	if(tptask->queueStartTime() > 0)
+	{
+		queueTimeHistogram_.add(startTime > tptask->queueStartTime() ? 
+			startTime - tptask->queueStartTime() : 0);
+	}
+
+	execTimeHistogram_.add(endTime > startTime ? endTime - startTime : 0);
 }
 
 //-------------------------------------------------------------------------------------
@@ -318,6 +437,14 @@ bool ThreadPool::createThreadPool(uint32 inewThreadCount,
 	normalThreadCount_ = inormalMaxThreadCount;
 	maxThreadCount_ = imaxThreadCount;
 	
+	// ÿפ߳һУ ʱ߳Щ
+	for(uint32 i=0; i<KBE_MAX(normalThreadCount_, (uint32)1); i++)
+	{
+		TaskDeque* pDeque = new TaskDeque();
+		THREAD_MUTEX_INIT(pDeque->mutex);
+		taskDeques_.push_back(pDeque);
+	}
+
 	for(uint32 i=0; i<normalThreadCount_; i++)
 	{
 		TPThread* tptd = createThread(0);
@@ -327,6 +454,8 @@ bool ThreadPool::createThreadPool(uint32 inewThreadCount,
 			ERROR_MSG("ThreadPool::createThreadPool: create thread is error! \n");
 		}
 
+		assignHomeDeque(tptd);
+
 		currentFreeThreadCount_++;	
 		currentThreadCount_++;
 		freeThreadList_.push_back(tptd);										// õ߳б
@@ -343,10 +472,25 @@ bool ThreadPool::createThreadPool(uint32 inewThreadCount,
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+void ThreadPool::takeFiniTasks()
+{
+	// һȡ߹̷߳ Ǻȳģ ԱɵȺ˳
+	TPTask* tptask = static_cast<TPTask*>(KBEConcurrency::atomicExchangePointer(
+		(void* volatile*)&finiTaskQueue_, NULL));
+
+	std::list<TPTask*>::iterator insertiter = finiTaskList_.end();
+	while(tptask)
+	{
+		insertiter = finiTaskList_.insert(insertiter, tptask);
+		tptask = tptask->pNextFiniTask_;
+	}
+}
+
 //-------------------------------------------------------------------------------------
 void ThreadPool::onMainThreadTick()
 {
-	THREAD_MUTEX_LOCK(finiTaskList_mutex_);
+	takeFiniTasks();
 
 	std::list<TPTask*>::iterator finiiter  = finiTaskList_.begin();
 
@@ -359,12 +503,12 @@ void ThreadPool::onMainThreadTick()
 		case thread::TPTask::TPTASK_STATE_COMPLETED:
 			delete (*finiiter);
 			finiTaskList_.erase(finiiter++);
-			--finiTaskList_count_;
+			KBEConcurrency::atomicAdd(&finiTaskList_count_, -1);
 			break;
 		case thread::TPTask::TPTASK_STATE_CONTINUE_CHILDTHREAD:
 			this->addTask((*finiiter));
 			finiTaskList_.erase(finiiter++);
-			--finiTaskList_count_;
+			KBEConcurrency::atomicAdd(&finiTaskList_count_, -1);
 			break;
 		case thread::TPTask::TPTASK_STATE_CONTINUE_MAINTHREAD:
 			++finiiter;
@@ -374,25 +518,29 @@ void ThreadPool::onMainThreadTick()
 			break;
 		};
 	}
-
-	THREAD_MUTEX_UNLOCK(finiTaskList_mutex_);	
 }
 
 //-------------------------------------------------------------------------------------
 void ThreadPool::bufferTask(TPTask* tptask)
 {
-	THREAD_MUTEX_LOCK(bufferedTaskList_mutex_);
+	KBE_ASSERT(taskDeques_.size() > 0);
+
+	// ̵߳ĶУ е̻߳ȡ
+	TaskDeque* pDeque = taskDeques_[(unsigned long)KBEConcurrency::atomicAdd(&nextTaskDeque_, 1) % 
+		taskDeques_.size()];
 
-	bufferedTaskList_.push(tptask);
+	// ȼٷ룬 ֤popbufferTaskΪ0ʱȷʵû
+	long size = KBEConcurrency::atomicAdd(&bufferedTaskCount_, 1) + 1;
+
+	THREAD_MUTEX_LOCK(pDeque->mutex);
+	pDeque->tasks.push_back(tptask);
+	THREAD_MUTEX_UNLOCK(pDeque->mutex);
 
-	size_t size = bufferedTaskList_.size();
 	if(size > THREAD_BUSY_SIZE)
 	{
 		WARNING_MSG(boost::format("ThreadPool::bufferTask: task buffered(%1%)!\n") % 
 			size);
 	}
-
-	THREAD_MUTEX_UNLOCK(bufferedTaskList_mutex_);
 }
 
 //-------------------------------------------------------------------------------------
@@ -498,6 +646,8 @@ bool ThreadPool::removeHangThread(TPThread* tptd)
 //-------------------------------------------------------------------------------------
 bool ThreadPool::addTask(TPTask* tptask)
 {
+	tptask->resetQueueStartTime();
+
 	THREAD_MUTEX_LOCK(threadStateList_mutex_);
 	if(currentFreeThreadCount_ > 0)
 	{
@@ -551,6 +701,8 @@ bool ThreadPool::addTask(TPTask* tptask)
 #endif				
 		}
 
+		assignHomeDeque(tptd);
+
 		allThreadList_.push_back(tptd);										// е߳б
 		freeThreadList_.push_back(tptd);									// õ߳б
 		++currentThreadCount_;
@@ -630,9 +782,12 @@ void* TPThread::threadFunc(void* arg)
 		while(task && !tptd->threadPool()->isDestroyed())
 		{
 			tptd->inc_done_tasks();
+
+			uint64 startTime = timestamp();
 			tptd->onProcessTaskStart(task);
 			tptd->processTask(task);							// 								
 			tptd->onProcessTaskEnd(task);
+			pThreadPool->onTaskProcessed(task, startTime, timestamp());
 
 			TPTask * task1 = tptd->tryGetTask();				// Լȡһæδ
 
@@ -753,7 +908,7 @@ void TPThread::onTaskCompleted(void)
 //-------------------------------------------------------------------------------------
 TPTask* TPThread::tryGetTask(void)
 {
-	return threadPool_->popbufferTask();
+	return threadPool_->popbufferTask(homeDeque_);
 }
 
 //-------------------------------------------------------------------------------------
@@ -29,12 +29,14 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include <assert.h>
 #include <iostream>	
 #include <list>
-#include <queue>
+#include <deque>
+#include <vector>
 #include <algorithm>
 #include "cstdkbe/cstdkbe.hpp"
 #include "cstdkbe/tasks.hpp"
 #include "helper/debug_helper.hpp"
 #include "thread/threadtask.hpp"
+#include "thread/concurrency.hpp"
 // windows include	
 #if KBE_PLATFORM == PLATFORM_WIN32
 #include <windows.h>          // for HANDLE
@@ -85,7 +87,8 @@ public:
 	TPThread(ThreadPool* threadPool, int threadWaitSecond = 0):
 	threadWaitSecond_(threadWaitSecond), 
 	currTask_(NULL), 
-	threadPool_(threadPool)
+	threadPool_(threadPool),
+	homeDeque_(0)
 	{
 		state_ = THREAD_STATE_SLEEP;
 		initCond();
@@ -219,6 +222,40 @@ protected:
 	ThreadPool* threadPool_;		// ָ̳߳
 	THREAD_STATE state_;			// ߳״̬: -1δ, 0˯, 1æ
 	uint32 done_tasks_;				// ߳һδı䵽״ִ̬е
+	uint32 homeDeque_;				// ߳ȡĶУ Ϊʱȡ
+};
+
+/*
+	ʱֲͳ
+	iͰ¼ʱС2^i΢ һͰ¼и ڶ߳ͬʱ¼
+*/
+class TPLatencyHistogram
+{
+public:
+	enum
+	{
+		NUM_BUCKETS = 24
+	};
+
+	TPLatencyHistogram();
+
+	/**
+		¼һκʱ(timestampλ)
+	*/
+	void add(uint64 stamps);
+
+	uint32 count()const{ return (uint32)count_; }
+
+	/**
+		ͳƽ Ҫṩwatcherʹ
+	*/
+	std::string print()const;
+
+protected:
+	uint64 percentile(uint32 rank)const;
+
+	volatile long buckets_[NUM_BUCKETS];
+	volatile long count_;
 };
 
 
@@ -240,6 +277,12 @@ public:
 	*/
 	std::string printThreadWorks();
 
+	/**
+		Ŷִкʱֲ(ṩwatch)
+	*/
+	std::string printQueueTimes(){ return queueTimeHistogram_.print(); }
+	std::string printExecTimes(){ return execTimeHistogram_.print(); }
+
 	/**
 		ȡǰ߳
 	*/	
@@ -297,17 +340,6 @@ public:
 	*/
 	INLINE uint32 bufferTaskSize()const;
 
-	/** 
-		û
-	*/
-	INLINE std::queue<thread::TPTask*>& bufferedTaskList();
-
-	/** 
-		
-	*/
-	INLINE void lockBufferedTaskList();
-	INLINE void unlockBufferedTaskList();
-
 	/** 
 		Ѿɵ
 	*/
@@ -329,8 +361,9 @@ public:
 
 	/**
 		δбȡһ бɾ
+		ȡhomeDequeеͷ Ϊʱеͷȡ
 	*/
-	TPTask* popbufferTask(void);
+	TPTask* popbufferTask(uint32 homeDeque);
 
 	/**
 		ƶһ̵߳б
@@ -346,23 +379,51 @@ public:
 		һѾɵб
 	*/	
 	void addFiniTask(TPTask* tptask);
+
+	/**
+		ɶеȫƵfiniTaskList_ ֻ߳е
+	*/
+	void takeFiniTasks();
 	
 	/**
 		ɾһ(ʱ)߳
 	*/	
 	bool removeHangThread(TPThread* tptd);
 
+	/**
+		¼Ŷִкʱ
+	*/
+	void onTaskProcessed(TPTask* tptask, uint64 startTime, uint64 endTime);
+
 	bool initializeWatcher();
 protected:
+	/*
+		ϵͳڷæʱδУ ÿ߳һȴĶ
+	*/
+	struct TaskDeque
+	{
+		std::deque<TPTask*> tasks;
+		THREAD_MUTEX mutex;
+	};
+
+	void clearTaskDeques();
+	void assignHomeDeque(TPThread* tptd);
+
 	bool isInitialize_;												// ̳߳Ƿ񱻳ʼ
 	
-	std::queue<TPTask*> bufferedTaskList_;							// ϵͳڷæʱδб
-	std::list<TPTask*> finiTaskList_;								// Ѿɵб
-	size_t finiTaskList_count_;
+	std::vector<TaskDeque*> taskDeques_;							// ϵͳڷæʱδ
+	volatile long bufferedTaskCount_;								// жδ
+	volatile long nextTaskDeque_;									// ѡĶ
+	uint32 nextHomeDeque_;											// ̵߳Ķ
+
+	TPTask* volatile finiTaskQueue_;								// ߳(ȳ) ߳һȡ
+	std::list<TPTask*> finiTaskList_;								// Ѿɵб ֻ߳з
+	volatile long finiTaskList_count_;
 
-	THREAD_MUTEX bufferedTaskList_mutex_;							// bufferTaskList
 	THREAD_MUTEX threadStateList_mutex_;							// bufferTaskList and freeThreadList_
-	THREAD_MUTEX finiTaskList_mutex_;								// finiTaskList
+
+	TPLatencyHistogram queueTimeHistogram_;							// Ͷݵ̳߳صʼִеĺʱ
+	TPLatencyHistogram execTimeHistogram_;							// ִкʱ
 	
 	std::list<TPThread*> busyThreadList_;							// æ߳б
 	std::list<TPThread*> freeThreadList_;							// õ߳б
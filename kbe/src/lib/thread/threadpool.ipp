@@ -9,7 +9,7 @@ INLINE bool ThreadPool::isInitialize(void)const
 
 INLINE bool ThreadPool::isBusy(void)const
 {
-	return bufferedTaskList_.size() > THREAD_BUSY_SIZE;
+	return bufferedTaskCount_ > THREAD_BUSY_SIZE;
 }	
 
 INLINE bool ThreadPool::isThreadCountMax(void)const
@@ -39,27 +39,12 @@ ThreadPool* TPThread::threadPool()
 
 INLINE uint32 ThreadPool::bufferTaskSize()const
 {
-	return bufferedTaskList_.size();
-}
-
-INLINE std::queue<thread::TPTask*>& ThreadPool::bufferedTaskList()
-{
-	return bufferedTaskList_;
-}
-
-INLINE void ThreadPool::lockBufferedTaskList()
-{
-	THREAD_MUTEX_LOCK(bufferedTaskList_mutex_);
-}
-
-INLINE void ThreadPool::unlockBufferedTaskList()
-{
-	THREAD_MUTEX_UNLOCK(bufferedTaskList_mutex_);
+	return (uint32)bufferedTaskCount_;
 }
 	
 INLINE uint32 ThreadPool::finiTaskSize()const
 {
-	return finiTaskList_count_;
+	return (uint32)finiTaskList_count_;
 }
 
 INLINE THREAD_ID TPThread::getID(void)const
@@ -25,6 +25,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 // #define NDEBUG
 #include "cstdkbe/cstdkbe.hpp"
 #include "cstdkbe/task.hpp"
+#include "cstdkbe/timestamp.hpp"
 #include "helper/debug_helper.hpp"
 
 namespace KBEngine{ namespace thread{
@@ -36,6 +37,14 @@ namespace KBEngine{ namespace thread{
 class TPTask : public Task
 {
 public:
+	friend class ThreadPool;
+
+	TPTask():
+	pNextFiniTask_(NULL),
+	queueStartTime_(0)
+	{
+	}
+
 	enum TPTaskState
 	{
 		/// һѾ
@@ -54,6 +63,17 @@ public:
 	virtual thread::TPTask::TPTaskState presentMainThread(){ 
 		return thread::TPTask::TPTASK_STATE_COMPLETED; 
 	}
+
+	/**
+		Ͷݵ̳߳(ThreadPool::addTask)ʱ䣬 ͳŶӺʱ
+		Ϊ0ʾûо̳߳Ŷ(tryGetTaskֱӽ) ͳ
+	*/
+	uint64 queueStartTime()const{ return queueStartTime_; }
+	void resetQueueStartTime(){ queueStartTime_ = timestamp(); }
+
+private:
+	TPTask* pNextFiniTask_;			// ɶеһ ThreadPoolά
+	uint64 queueStartTime_;
 };
 
 }
@@ -71,7 +71,10 @@ shouldAutoArchive_(1),
 shouldAutoBackup_(1),
 creatingCell_(false),
 createdSpace_(false),
-inRestore_(false)
+inRestore_(false),
+dirtyPersistentProperties_(),
+persistentDigests_(),
+persistentsAllDirty_(false)
 {
 	ENTITY_INIT_PROPERTYS(Base);
 
@@ -92,6 +95,8 @@ Base::~Base()
 void Base::onDefDataChanged(const PropertyDescription* propertyDescription, 
 		PyObject* pyData)
 {
+	if(propertyDescription->isPersistent())
+		dirtyPersistentProperties_.insert(propertyDescription->getUType());
 }
 
 //-------------------------------------------------------------------------------------
@@ -281,7 +286,35 @@ void Base::addCellDataToStream(uint32 flags, MemoryStream* s, bool useAliasID)
 }
 
 //-------------------------------------------------------------------------------------
-void Base::addPersistentsDataToStream(uint32 flags, MemoryStream* s)
+bool Base::updatePersistentDigest(ENTITY_PROPERTY_UID uid, MemoryStream* s, size_t wpos)
+{
+	// FNV-1a
+	uint64 digest = 14695981039346656037ULL;
+	const uint8* pData = s->data() + wpos;
+	const uint8* pEnd = s->data() + s->wpos();
+
+	for(; pData != pEnd; ++pData)
+	{
+		digest ^= *pData;
+		digest *= 1099511628211ULL;
+	}
+
+	std::map<ENTITY_PROPERTY_UID, uint64>::iterator iter = persistentDigests_.find(uid);
+	if(iter == persistentDigests_.end())
+	{
+		persistentDigests_[uid] = digest;
+		return true;
+	}
+
+	if(iter->second == digest)
+		return false;
+
+	iter->second = digest;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void Base::addPersistentsDataToStream(uint32 flags, MemoryStream* s, bool onlyChanged)
 {
 	std::vector<ENTITY_PROPERTY_UID> log;
 
@@ -292,9 +325,15 @@ void Base::addPersistentsDataToStream(uint32 flags, MemoryStream* s)
 	ScriptDefModule::PROPERTYDESCRIPTION_MAP& propertyDescrs = scriptModule_->getPersistentPropertyDescriptions();
 	ScriptDefModule::PROPERTYDESCRIPTION_MAP::const_iterator iter = propertyDescrs.begin();
 
+	// ûиıдٴ˻أ ݿ⽫ֻ¸ı˵ӱ
+	size_t wpos = s->wpos();
+
 	if(scriptModule_->hasCell())
 	{
 		addPositionAndDirectionToStream(*s);
+
+		if(!updatePersistentDigest(ENTITY_BASE_PROPERTY_UTYPE_POSITION_XYZ, s, wpos) && onlyChanged)
+			s->wpos(wpos);
 	}
 
 	for(; iter != propertyDescrs.end(); iter++)
@@ -310,6 +349,7 @@ void Base::addPersistentsDataToStream(uint32 flags, MemoryStream* s)
 		if(propertyDescription->isPersistent() && (flags & propertyDescription->getFlags()) > 0)
 		{
 			PyObject *key = PyUnicode_FromString(attrname);
+			wpos = s->wpos();
 
 			if(cellDataDict_ != NULL && PyDict_Contains(cellDataDict_, key) > 0)
 			{
@@ -325,6 +365,10 @@ void Base::addPersistentsDataToStream(uint32 flags, MemoryStream* s)
 					log.push_back(propertyDescription->getUType());
 					propertyDescription->addPersistentToStream(s, pyVal);
 					DEBUG_PERSISTENT_PROPERTY("addCellPersistentsDataToStream", attrname);
+
+					// cellֵcellݹ base޷֪Щı
+					if(!updatePersistentDigest(propertyDescription->getUType(), s, wpos) && onlyChanged)
+						s->wpos(wpos);
 				}
 			}
 			else if(PyDict_Contains(pydict, key) > 0)
@@ -335,12 +379,17 @@ void Base::addPersistentsDataToStream(uint32 flags, MemoryStream* s)
 					CRITICAL_MSG(boost::format("%1%::addPersistentsDataToStream: %2% persistent[%3%] type(curr_py: %4% != %5%) is error.\n") %
 						this->getScriptName() % this->getID() % attrname % pyVal->ob_type->tp_name % propertyDescription->getDataType()->getName());
 				}
-				else
+				else if(!onlyChanged || propertyDescription->isMutableValue() || 
+					dirtyPersistentProperties_.find(propertyDescription->getUType()) != dirtyPersistentProperties_.end())
 				{
 	    			(*s) << propertyDescription->getUType();
 					log.push_back(propertyDescription->getUType());
 	    			propertyDescription->addPersistentToStream(s, pyVal);
 					DEBUG_PERSISTENT_PROPERTY("addBasePersistentsDataToStream", attrname);
+
+					if(propertyDescription->isMutableValue() && 
+						!updatePersistentDigest(propertyDescription->getUType(), s, wpos) && onlyChanged)
+						s->wpos(wpos);
 				}
 			}
 			else
@@ -925,6 +974,10 @@ void Base::onWriteToDBCallback(ENTITY_ID eid,
 {
 	isArchiveing_ = false;
 
+	// дʧܺݿеѾ޷ȷ һδ浵де
+	if(!success)
+		persistentsAllDirty_ = true;
+
 	PyObjectPtr pyCallback;
 
 	if(callbackID > 0)
@@ -991,8 +1044,11 @@ void Base::onCellWriteToDBCompleted(CALLBACK_ID callbackID)
 		return;
 	}
 
+	// ݿѾʵʱֻҪ¸ı˵
 	MemoryStream* s = MemoryStream::ObjPool().createObject();
-	addPersistentsDataToStream(ED_FLAG_ALL, s);
+	addPersistentsDataToStream(ED_FLAG_ALL, s, this->getDBID() > 0 && !persistentsAllDirty_);
+	dirtyPersistentProperties_.clear();
+	persistentsAllDirty_ = false;
 
 	Mercury::Bundle* pBundle = Mercury::Bundle::ObjPool().createObject();
 	(*pBundle).newMessage(DbmgrInterface::writeEntity);
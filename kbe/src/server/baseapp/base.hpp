@@ -125,7 +125,10 @@ public:
 
 	void destroyCellData(void);
 
-	void addPersistentsDataToStream(uint32 flags, MemoryStream* s);
+	/**
+		洢д onlyChangedΪtrueʱֻдһδ浵֮ı
+	*/
+	void addPersistentsDataToStream(uint32 flags, MemoryStream* s, bool onlyChanged = false);
 
 	PyObject* createCellDataDict(uint32 flags);
 
@@ -276,6 +279,13 @@ public:
 		cellapp
 	*/
 	void onCellAppDeath();
+
+protected:
+	/**
+		дwposʼݵժҪ һдʱժҪȽǷı
+	*/
+	bool updatePersistentDigest(ENTITY_PROPERTY_UID uid, MemoryStream* s, size_t wpos);
+
 protected:
 	// entityĿͻmailbox cellapp mailbox
 	EntityMailbox*							clientMailbox_;			
@@ -308,6 +318,15 @@ protected:
 
 	// Ƿڻָ
 	bool									inRestore_;
+
+	// һδ浵֮󱻽űֵbaseִ洢
+	std::set<ENTITY_PROPERTY_UID>			dirtyPersistentProperties_;
+
+	// ޷ֵ֪ͨıĴ洢(cellֵԡԭ޸ĵԡλó)һдʱժҪ
+	std::map<ENTITY_PROPERTY_UID, uint64>	persistentDigests_;
+
+	// һдʧܣ һδ浵ҪдеĴ洢
+	bool									persistentsAllDirty_;
 };
 
 }
@@ -2579,6 +2579,20 @@ void Baseapp::onQueryAccountCBFromDbmgr(Mercury::Channel* pChannel, KBEngine::Me
 //-------------------------------------------------------------------------------------
 void Baseapp::forwardMessageToClientFromCellapp(Mercury::Channel* pChannel, 
 												KBEngine::MemoryStream& s)
+{
+	forwardMessageToClient(pChannel, s, true);
+}
+
+//-------------------------------------------------------------------------------------
+void Baseapp::forwardVolatileMessageToClientFromCellapp(Mercury::Channel* pChannel, 
+												KBEngine::MemoryStream& s)
+{
+	forwardMessageToClient(pChannel, s, false);
+}
+
+//-------------------------------------------------------------------------------------
+void Baseapp::forwardMessageToClient(Mercury::Channel* pChannel, 
+									KBEngine::MemoryStream& s, bool reliable)
 {
 	if(pChannel->isExternal())
 		return;
@@ -2683,6 +2697,7 @@ void Baseapp::forwardMessageToClientFromCellapp(Mercury::Channel* pChannel,
 		return;
 
 	Mercury::Bundle* pBundle = Mercury::Bundle::ObjPool().createObject();
+	(*pBundle).reliable(reliable);
 	(*pBundle).append(s);
 	static_cast<Proxy*>(base)->sendToClient(pBundle);
 	//mailbox->postMail((*pBundle));
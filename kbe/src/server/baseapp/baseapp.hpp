@@ -311,6 +311,13 @@ public:
 	*/
 	void forwardMessageToClientFromCellapp(Mercury::Channel* pChannel, KBEngine::MemoryStream& s);
 
+	/** ӿ
+		cellappתentityױݸclient ʧش
+	*/
+	void forwardVolatileMessageToClientFromCellapp(Mercury::Channel* pChannel, KBEngine::MemoryStream& s);
+
+	void forwardMessageToClient(Mercury::Channel* pChannel, KBEngine::MemoryStream& s, bool reliable);
+
 	/** ӿ
 		cellappתentityϢĳbaseEntitycellEntity
 	*/
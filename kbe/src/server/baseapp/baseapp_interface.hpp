@@ -195,6 +195,9 @@ NETWORK_INTERFACE_DECLARE_BEGIN(BaseappInterface)
 	// cellappתentityϢclient
 	BASEAPP_MESSAGE_DECLARE_STREAM(forwardMessageToClientFromCellapp,				MERCURY_VARIABLE_MESSAGE)
 
+	// cellappתentityױ(λá)client ڿɿUDP߲ɿͨ
+	BASEAPP_MESSAGE_DECLARE_STREAM(forwardVolatileMessageToClientFromCellapp,		MERCURY_VARIABLE_MESSAGE)
+
 	// cellappתentityϢĳbaseEntitycellEntity
 	BASEAPP_MESSAGE_DECLARE_STREAM(forwardMessageToCellappFromCellapp,				MERCURY_VARIABLE_MESSAGE)
 
@@ -384,6 +384,8 @@ void Proxy::onGiveClientTo(Mercury::Channel* lpChannel)
 void Proxy::onDefDataChanged(const PropertyDescription* propertyDescription, 
 		PyObject* pyData)
 {
+	Base::onDefDataChanged(propertyDescription, pyData);
+
 	uint32 flags = propertyDescription->getFlags();
 
 	if((flags & ED_FLAG_BASE_AND_CLIENT) <= 0 || clientMailbox_ == NULL)
@@ -220,7 +220,21 @@ void Cellapp::handleGameTick()
 
 	EntityApp<Entity>::handleGameTick();
 
+	// ӳٸģʽͳһspaceϵͳ Ȼٸwitness
+	Spaces::update();
+
+#if ENABLE_WATCHERS
+	// quantity¼tickwitnessȸʱBundleMemoryStreamطĴ
+	size_t poolCreateCount = Mercury::Bundle::ObjPool().createCount() + MemoryStream::ObjPool().createCount();
+	START_PROFILE(UPDATABLES_PROFILE);
+#endif
+
 	updatables_.update();
+
+#if ENABLE_WATCHERS
+	STOP_PROFILE_WITH_DATA(UPDATABLES_PROFILE, (uint32)(Mercury::Bundle::ObjPool().createCount() + 
+		MemoryStream::ObjPool().createCount() - poolCreateCount));
+#endif
 }
 
 //-------------------------------------------------------------------------------------
@@ -244,6 +258,11 @@ bool Cellapp::initializeEnd()
 	// ǷY
 	CoordinateSystem::hasY = g_kbeSrvConfig.getCellApp().coordinateSystem_hasY;
 
+	// Ƿʹڵ
+	CoordinateSystem::useGrid = g_kbeSrvConfig.getCellApp().coordinateSystem_useGrid;
+	CoordinateSystem::gridSize = g_kbeSrvConfig.getCellApp().coordinateSystem_gridSize;
+	CoordinateSystem::deferredUpdate = g_kbeSrvConfig.getCellApp().coordinateSystem_deferredUpdate;
+
 	mainDispatcher_.clearSpareTime();
 
 	pGhostManager_ = new GhostManager();
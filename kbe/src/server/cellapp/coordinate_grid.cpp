@@ -0,0 +1,147 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2012 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "coordinate_grid.hpp"
+#include "coordinate_node.hpp"
+
+#ifndef CODE_INLINE
+#include "coordinate_grid.ipp"
+#endif
+
+namespace KBEngine{	
+
+//-------------------------------------------------------------------------------------
+CoordinateGrid::CoordinateGrid(float gridSize):
+gridSize_(gridSize > 0.f ? gridSize : 100.f),
+grids_(),
+size_(0)
+{
+}
+
+//-------------------------------------------------------------------------------------
+CoordinateGrid::~CoordinateGrid()
+{
+	grids_.clear();
+	size_ = 0;
+}
+
+//-------------------------------------------------------------------------------------
+void CoordinateGrid::addNode(CoordinateNode* pNode)
+{
+	KBE_ASSERT(pNode->gridIndex() < 0);
+
+	uint64 key = makeKey(toGridPos(pNode->xx()), toGridPos(pNode->zz()));
+	NODES& nodes = grids_[key];
+
+	pNode->gridKey(key);
+	pNode->gridIndex((int32)nodes.size());
+	nodes.push_back(pNode);
+	++size_;
+}
+
+//-------------------------------------------------------------------------------------
+void CoordinateGrid::removeNode(CoordinateNode* pNode)
+{
+	if(pNode->gridIndex() < 0)
+		return;
+
+	GRIDS::iterator iter = grids_.find(pNode->gridKey());
+	KBE_ASSERT(iter != grids_.end());
+
+	// һڵ㽻ɾ ƶ
+	NODES& nodes = iter->second;
+	int32 idx = pNode->gridIndex();
+	KBE_ASSERT(idx < (int32)nodes.size() && nodes[idx] == pNode);
+
+	CoordinateNode* pLastNode = nodes.back();
+	nodes[idx] = pLastNode;
+	pLastNode->gridIndex(idx);
+	nodes.pop_back();
+
+	if(nodes.size() == 0)
+		grids_.erase(iter);
+
+	pNode->gridIndex(-1);
+	--size_;
+}
+
+//-------------------------------------------------------------------------------------
+void CoordinateGrid::moveNode(CoordinateNode* pNode)
+{
+	if(pNode->gridIndex() >= 0 && 
+		pNode->gridKey() == makeKey(toGridPos(pNode->xx()), toGridPos(pNode->zz())))
+		return;
+
+	removeNode(pNode);
+	addNode(pNode);
+}
+
+//-------------------------------------------------------------------------------------
+void CoordinateGrid::queryNodes(NODES& nodes, float minx, float minz, float maxx, float maxz)
+{
+	int32 gminx = toGridPos(minx);
+	int32 gminz = toGridPos(minz);
+	int32 gmaxx = toGridPos(maxx);
+	int32 gmaxz = toGridPos(maxz);
+
+	uint64 count = (uint64)(gmaxx - gminx + 1) * (uint64)(gmaxz - gminz + 1);
+
+	// Χǵʵʴڵ񻹶ʱֱӱдڵ
+	if(count > grids_.size())
+	{
+		GRIDS::iterator iter = grids_.begin();
+		for(; iter != grids_.end(); iter++)
+		{
+			int32 gx = (int32)(uint32)(iter->first >> 32);
+			int32 gz = (int32)(uint32)(iter->first & 0xffffffff);
+
+			if(gx < gminx || gx > gmaxx || gz < gminz || gz > gmaxz)
+				continue;
+
+			nodes.insert(nodes.end(), iter->second.begin(), iter->second.end());
+		}
+
+		return;
+	}
+
+	for(int32 gx = gminx; gx <= gmaxx; gx++)
+	{
+		for(int32 gz = gminz; gz <= gmaxz; gz++)
+		{
+			GRIDS::iterator iter = grids_.find(makeKey(gx, gz));
+			if(iter == grids_.end())
+				continue;
+
+			nodes.insert(nodes.end(), iter->second.begin(), iter->second.end());
+		}
+	}
+}
+
+//-------------------------------------------------------------------------------------
+void CoordinateGrid::allNodes(NODES& nodes)
+{
+	GRIDS::iterator iter = grids_.begin();
+	for(; iter != grids_.end(); iter++)
+	{
+		nodes.insert(nodes.end(), iter->second.begin(), iter->second.end());
+	}
+}
+
+//-------------------------------------------------------------------------------------
+}
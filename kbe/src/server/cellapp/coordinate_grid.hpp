@@ -0,0 +1,86 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2012 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef KBE_COORDINATE_GRID_HPP
+#define KBE_COORDINATE_GRID_HPP
+
+#include "helper/debug_helper.hpp"
+#include "cstdkbe/cstdkbe.hpp"	
+
+namespace KBEngine{
+
+class CoordinateNode;
+
+/*
+	ռ
+	xzƽ滮Ϊ߳ΪgridSize ÿڵչ(xx, zz)ӦУ
+	Թϣ洢 ֻдڽڵŻռڴ档
+	ĳηΧڵĽڵֻҪǸ÷Χ ڽڵȡ
+*/
+class CoordinateGrid
+{
+public:
+	typedef std::vector<CoordinateNode*> NODES;
+	typedef KBEUnordered_map<uint64, NODES> GRIDS;
+
+	CoordinateGrid(float gridSize);
+	~CoordinateGrid();
+
+	/**
+		ɾڵ
+	*/
+	void addNode(CoordinateNode* pNode);
+	void removeNode(CoordinateNode* pNode);
+
+	/**
+		ڵб䶯 Խƶµ
+	*/
+	void moveNode(CoordinateNode* pNode);
+
+	/**
+		þηΧеĽڵ
+	*/
+	void queryNodes(NODES& nodes, float minx, float minz, float maxx, float maxz);
+
+	/**
+		нڵ
+	*/
+	void allNodes(NODES& nodes);
+
+	INLINE float gridSize()const;
+	INLINE uint32 size()const;
+
+	INLINE int32 toGridPos(float v)const;
+	INLINE uint64 makeKey(int32 gx, int32 gz)const;
+
+protected:
+	float gridSize_;
+	
+	GRIDS grids_;
+
+	uint32 size_;
+};
+
+}
+
+#ifdef CODE_INLINE
+#include "coordinate_grid.ipp"
+#endif
+#endif
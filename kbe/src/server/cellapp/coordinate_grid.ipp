@@ -0,0 +1,52 @@
+/*
+This source file is part of KBEngine
+For the latest info, see http://www.kbengine.org/
+
+Copyright (c) 2008-2012 KBEngine.
+
+KBEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+KBEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+ 
+You should have received a copy of the GNU Lesser General Public License
+along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+namespace KBEngine{
+
+//-------------------------------------------------------------------------------------
+INLINE float CoordinateGrid::gridSize()const{ return gridSize_; }
+
+//-------------------------------------------------------------------------------------
+INLINE uint32 CoordinateGrid::size()const{ return size_; }
+
+//-------------------------------------------------------------------------------------
+INLINE int32 CoordinateGrid::toGridPos(float v)const
+{
+	// ɾĽڵΪ-FLT_MAX һ·Χֹ
+	float pos = floorf(v / gridSize_);
+
+	if(pos < -1000000000.f)
+		return -1000000000;
+
+	if(pos > 1000000000.f)
+		return 1000000000;
+
+	return (int32)pos;
+}
+
+//-------------------------------------------------------------------------------------
+INLINE uint64 CoordinateGrid::makeKey(int32 gx, int32 gz)const
+{
+	return (((uint64)(uint32)gx) << 32) | (uint64)(uint32)gz;
+}
+
+//-------------------------------------------------------------------------------------
+}
@@ -36,6 +36,9 @@ pNextY_(NULL),
 pPrevZ_(NULL),
 pNextZ_(NULL),
 pCoordinateSystem_(pCoordinateSystem),
+gridKey_(0),
+gridIndex_(-1),
+dirtyIndex_(-1),
 x_(-FLT_MAX),
 y_(-FLT_MAX),
 z_(-FLT_MAX),
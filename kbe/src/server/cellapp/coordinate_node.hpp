@@ -33,6 +33,8 @@ namespace KBEngine{
 #define COORDINATE_NODE_FLAG_REMOVEING				0x00000008		// ɾڵ
 #define COORDINATE_NODE_FLAG_REMOVED				0x00000010		// ɾڵ
 #define COORDINATE_NODE_FLAG_PENDING				0x00000020		// ڵ㴦updateС
+#define COORDINATE_NODE_FLAG_POSITIVE_BOUNDARY		0x00000040		// ߽ڵ(ģʽ)
+#define COORDINATE_NODE_FLAG_DIRTY					0x00000080		// Ѹı䣬 ȴtickͳһ
 
 #define COORDINATE_NODE_FLAG_HIDE_OR_REMOVED		(COORDINATE_NODE_FLAG_REMOVED | COORDINATE_NODE_FLAG_HIDE)
 
@@ -74,6 +76,12 @@ public:
 	float old_yy()const { return old_yy_; }
 	float old_zz()const { return old_zz_; }
 
+	/**
+		ڵxzƽϵĸǷΧ ֻдڵ
+		ģʽȷҪڽ
+	*/
+	virtual float range_xz()const { return 0.f; }
+
 	virtual void resetOld(){ 
 		old_xx_ = xx();
 		old_yy_ = yy();
@@ -109,6 +117,20 @@ public:
 	INLINE void pPrevZ(CoordinateNode* pNode);
 	INLINE void pNextZ(CoordinateNode* pNode);
 
+	/**
+		ģʽ½ڵڵԼе
+	*/
+	INLINE uint64 gridKey()const;
+	INLINE void gridKey(uint64 key);
+	INLINE int32 gridIndex()const;
+	INLINE void gridIndex(int32 idx);
+
+	/**
+		ڵϵͳȴбе ɾʱֱĩβƳ
+	*/
+	INLINE int32 dirtyIndex()const;
+	INLINE void dirtyIndex(int32 idx);
+
 	/**
 		ĳڵ䶯˱ڵ
 		@isfront: ǰƶƶ
@@ -149,6 +171,13 @@ protected:
 
 	CoordinateSystem* pCoordinateSystem_;
 
+	// ģʽڵԼе -1Ϊ
+	uint64 gridKey_;
+	int32 gridIndex_;
+
+	// ڵȴбе -1Ϊб
+	int32 dirtyIndex_;
+
 	float x_, y_, z_;
 	float old_xx_, old_yy_, old_zz_;
 
@@ -37,6 +37,14 @@ INLINE void CoordinateNode::pNextY(CoordinateNode* pNode){ if(pNode != NULL)KBE_
 INLINE void CoordinateNode::pPrevZ(CoordinateNode* pNode){ if(pNode != NULL)KBE_ASSERT(pPrevZ_ != pNode); pPrevZ_ = pNode; }
 INLINE void CoordinateNode::pNextZ(CoordinateNode* pNode){ if(pNode != NULL)KBE_ASSERT(pNextZ_ != pNode); pNextZ_ = pNode; }
 
+//-------------------------------------------------------------------------------------
+INLINE uint64 CoordinateNode::gridKey()const{ return gridKey_; }
+INLINE void CoordinateNode::gridKey(uint64 key){ gridKey_ = key; }
+INLINE int32 CoordinateNode::gridIndex()const{ return gridIndex_; }
+INLINE void CoordinateNode::gridIndex(int32 idx){ gridIndex_ = idx; }
+INLINE int32 CoordinateNode::dirtyIndex()const{ return dirtyIndex_; }
+INLINE void CoordinateNode::dirtyIndex(int32 idx){ dirtyIndex_ = idx; }
+
 //-------------------------------------------------------------------------------------
 INLINE void CoordinateNode::pCoordinateSystem(CoordinateSystem* p){ pCoordinateSystem_ = p; }
 
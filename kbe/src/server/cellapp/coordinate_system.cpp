@@ -19,6 +19,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "coordinate_node.hpp"
 #include "coordinate_system.hpp"
+#include "coordinate_grid.hpp"
 #include "profile.hpp"
 
 #ifndef CODE_INLINE
@@ -28,6 +29,12 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 namespace KBEngine{	
 
 bool CoordinateSystem::hasY = false;
+bool CoordinateSystem::useGrid = false;
+float CoordinateSystem::gridSize = 100.f;
+bool CoordinateSystem::deferredUpdate = false;
+
+// Ľڵ㲻Ҫ
+static const size_t DIRTY_NODES_SORT_THRESHOLD = 32;
 
 //-------------------------------------------------------------------------------------
 CoordinateSystem::CoordinateSystem():
@@ -37,7 +44,15 @@ first_y_coordinateNode_(NULL),
 first_z_coordinateNode_(NULL),
 dels_(),
 dels_count_(0),
-updating_(0)
+updating_(0),
+pGrid_(NULL),
+maxRange_xz_(0.f),
+gridNodes_(),
+dirtyNodes_(),
+sortNodes_(),
+sortKeys_(),
+sortKeysTmp_(),
+updatingDirtyNodes_(false)
 {
 }
 
@@ -47,6 +62,22 @@ CoordinateSystem::~CoordinateSystem()
 	dels_.clear();
 	dels_count_ = 0;
 
+	if(pGrid_)
+	{
+		std::vector<CoordinateNode*> nodes;
+		pGrid_->allNodes(nodes);
+
+		std::vector<CoordinateNode*>::iterator iter = nodes.begin();
+		for(; iter != nodes.end(); iter++)
+		{
+			(*iter)->pCoordinateSystem(NULL);
+			delete (*iter);
+		}
+
+		SAFE_RELEASE(pGrid_);
+		size_ = 0;
+	}
+
 	if(first_x_coordinateNode_)
 	{
 		CoordinateNode* pNode = first_x_coordinateNode_;
@@ -73,9 +104,45 @@ CoordinateSystem::~CoordinateSystem()
 	}
 }
 
+//-------------------------------------------------------------------------------------
+bool CoordinateSystem::initGrid(float gridSize)
+{
+	if(!isEmpty() || pGrid_ != NULL)
+	{
+		ERROR_MSG(boost::format("CoordinateSystem::initGrid: size=%1%, grid=%2%!\n") % size_ % pGrid_);
+		return false;
+	}
+
+	pGrid_ = new CoordinateGrid(gridSize);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void CoordinateSystem::nodesInRange(std::vector<CoordinateNode*>& nodes, float x, float z, float radius)
+{
+	if(pGrid_ == NULL)
+		return;
+
+	pGrid_->queryNodes(nodes, x - radius, z - radius, x + radius, z + radius);
+}
+
 //-------------------------------------------------------------------------------------
 bool CoordinateSystem::insert(CoordinateNode* pNode)
 {
+	if(pGrid_)
+	{
+		pNode->old_xx(-FLT_MAX);
+		pNode->old_yy(-FLT_MAX);
+		pNode->old_zz(-FLT_MAX);
+		pNode->pCoordinateSystem(this);
+
+		pGrid_->addNode(pNode);
+		++size_;
+
+		update(pNode);
+		return true;
+	}
+
 	// ǿյ, ʼһһxzڵΪýڵ
 	if(isEmpty())
 	{
@@ -182,6 +249,31 @@ bool CoordinateSystem::removeReal(CoordinateNode* pNode)
 		return true;
 	}
 
+	if((pNode->flags() & COORDINATE_NODE_FLAG_DIRTY) > 0)
+	{
+		pNode->flags(pNode->flags() & ~COORDINATE_NODE_FLAG_DIRTY);
+
+		// ͳһ¹бѾȥ Ǻʱ
+		int32 idx = pNode->dirtyIndex();
+		if(!updatingDirtyNodes_ && idx >= 0 && idx < (int32)dirtyNodes_.size() && dirtyNodes_[idx] == pNode)
+		{
+			CoordinateNode* pLastNode = dirtyNodes_.back();
+			dirtyNodes_[idx] = pLastNode;
+			pLastNode->dirtyIndex(idx);
+			dirtyNodes_.pop_back();
+		}
+
+		pNode->dirtyIndex(-1);
+	}
+
+	if(pGrid_)
+	{
+		pGrid_->removeNode(pNode);
+		pNode->pCoordinateSystem(NULL);
+		--size_;
+		return true;
+	}
+
 	// ǵһڵ
 	if(first_x_coordinateNode_ == pNode)
 	{
@@ -428,6 +520,20 @@ void CoordinateSystem::update(CoordinateNode* pNode)
 	pNode->flags(pNode->flags() | COORDINATE_NODE_FLAG_PENDING);
 	++updating_;
 
+	if(pGrid_)
+	{
+		updateGrid(pNode);
+
+		pNode->resetOld();
+		pNode->flags(pNode->flags() & ~COORDINATE_NODE_FLAG_PENDING);
+		--updating_;
+
+		if(updating_ == 0)
+			removeDelNodes();
+
+		return;
+	}
+
 	if(pNode->xx() != pNode->old_xx())
 	{
 		while(true)
@@ -652,4 +758,231 @@ void CoordinateSystem::update(CoordinateNode* pNode)
 }
 
 //-------------------------------------------------------------------------------------
+void CoordinateSystem::updateGrid(CoordinateNode* pNode)
+{
+	float oldx = pNode->old_xx(), oldz = pNode->old_zz();
+	float newx = pNode->xx(), newz = pNode->zz();
+
+	if(newx == oldx && newz == oldz && (!CoordinateSystem::hasY || pNode->yy() == pNode->old_yy()))
+		return;
+
+	pGrid_->moveNode(pNode);
+
+	pNode->x(newx);
+	pNode->y(pNode->yy());
+	pNode->z(newz);
+
+	bool isTrigger = (pNode->flags() & COORDINATE_NODE_FLAG_TRIGGER) > 0;
+
+	// ÿֻ߽ڵ ͬһ¼ᱻ߽һ
+	if(isTrigger && (pNode->flags() & COORDINATE_NODE_FLAG_POSITIVE_BOUNDARY) <= 0)
+		return;
+
+	if(isTrigger)
+	{
+		float range = fabs(pNode->range_xz());
+		if(range > maxRange_xz_)
+			maxRange_xz_ = range;
+	}
+
+	// ²߱ɾĽڵЧ(+-FLT_MAX), ʱֻҪһ
+	bool oldValid = fabs(oldx) < FLT_MAX && fabs(oldz) < FLT_MAX;
+	bool newValid = fabs(newx) < FLT_MAX && fabs(newz) < FLT_MAX;
+
+	if(!oldValid && !newValid)
+		return;
+
+	float minx = oldValid ? oldx : newx;
+	float maxx = minx;
+	float minz = oldValid ? oldz : newz;
+	float maxz = minz;
+
+	if(oldValid && newValid)
+	{
+		minx = std::min(oldx, newx);
+		maxx = std::max(oldx, newx);
+		minz = std::min(oldz, newz);
+		maxz = std::max(oldz, newz);
+	}
+
+	// ߽ڵλڴԭ+range, 뱻Ľڵľ벻ᳬ2range
+	float searchRange = maxRange_xz_ * 2.f;
+	if(isTrigger)
+	{
+		minx -= searchRange;
+		minz -= searchRange;
+	}
+	else
+	{
+		maxx += searchRange;
+		maxz += searchRange;
+	}
+
+	// صпܻǶupdate ֻʲڽʱԭ
+	size_t start = gridNodes_.size();
+	pGrid_->queryNodes(gridNodes_, minx, minz, maxx, maxz);
+	size_t end = gridNodes_.size();
+
+	for(size_t i = start; i < end; ++i)
+	{
+		CoordinateNode* pCurrNode = gridNodes_[i];
+		if(pCurrNode == pNode || pCurrNode->pCoordinateSystem() != this)
+			continue;
+
+		uint32 currflags = pCurrNode->flags();
+		if((currflags & COORDINATE_NODE_FLAG_REMOVED) > 0)
+			continue;
+
+		if(isTrigger)
+		{
+			if((currflags & COORDINATE_NODE_FLAG_TRIGGER) > 0)
+				continue;
+
+			if((currflags & COORDINATE_NODE_FLAG_HIDE_OR_REMOVED) <= 0)
+				onNodePassGrid(pNode, pCurrNode, false);
+		}
+		else
+		{
+			if((currflags & COORDINATE_NODE_FLAG_POSITIVE_BOUNDARY) <= 0)
+				continue;
+
+			if((pNode->flags() & COORDINATE_NODE_FLAG_HIDE_OR_REMOVED) <= 0)
+				onNodePassGrid(pCurrNode, pNode, true);
+		}
+	}
+
+	gridNodes_.resize(start);
+}
+
+//-------------------------------------------------------------------------------------
+void CoordinateSystem::onNodePassGrid(CoordinateNode* pNode, CoordinateNode* pCurrNode, bool isfront)
+{
+	// X/Y/Z¼ֻᴦһ(ȡĸϵķΧ״̬˱仯)
+	// ɷ¼ɵõģʽһµĽ/뿪
+	pNode->onNodePassX(pCurrNode, isfront);
+
+	if(CoordinateSystem::hasY)
+		pNode->onNodePassY(pCurrNode, isfront);
+
+	pNode->onNodePassZ(pCurrNode, isfront);
 }
+
+//-------------------------------------------------------------------------------------
+bool CoordinateSystem::addDirtyNode(CoordinateNode* pNode)
+{
+	// ͳһ¹в仯(صƶʵ)
+	if(!CoordinateSystem::deferredUpdate || updatingDirtyNodes_)
+		return false;
+
+	if((pNode->flags() & (COORDINATE_NODE_FLAG_REMOVEING | COORDINATE_NODE_FLAG_REMOVED)) > 0)
+		return false;
+
+	if((pNode->flags() & COORDINATE_NODE_FLAG_DIRTY) > 0)
+		return true;
+
+	pNode->flags(pNode->flags() | COORDINATE_NODE_FLAG_DIRTY);
+	pNode->dirtyIndex((int32)dirtyNodes_.size());
+	dirtyNodes_.push_back(pNode);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+void CoordinateSystem::updateDirtyNodes()
+{
+	if(dirtyNodes_.size() == 0 || updatingDirtyNodes_)
+		return;
+
+	AUTO_SCOPED_PROFILE("coordinateSystemDirtyUpdates");
+
+	updatingDirtyNodes_ = true;
+
+	if(dirtyNodes_.size() >= DIRTY_NODES_SORT_THRESHOLD)
+		sortDirtyNodes();
+
+	// Ƚ ¹нڵ㱻ɾʱȥ޸б
+	sortNodes_.swap(dirtyNodes_);
+	dirtyNodes_.clear();
+
+	std::vector<CoordinateNode*>::iterator iter = sortNodes_.begin();
+	for(; iter != sortNodes_.end(); iter++)
+	{
+		CoordinateNode* pNode = (*iter);
+		if((pNode->flags() & COORDINATE_NODE_FLAG_DIRTY) <= 0)
+			continue;
+
+		pNode->flags(pNode->flags() & ~COORDINATE_NODE_FLAG_DIRTY);
+		pNode->dirtyIndex(-1);
+
+		if(pNode->pCoordinateSystem() != this)
+			continue;
+
+		pNode->update();
+	}
+
+	sortNodes_.clear();
+	updatingDirtyNodes_ = false;
+}
+
+//-------------------------------------------------------------------------------------
+void CoordinateSystem::sortDirtyNodes()
+{
+	size_t count = dirtyNodes_.size();
+
+	sortKeys_.resize(count);
+	sortKeysTmp_.resize(count);
+	sortNodes_.resize(count);
+
+	// xz(ģʽΪ)Ϊ16λƴһ32λkey xڸλ
+	for(size_t i = 0; i < count; ++i)
+	{
+		CoordinateNode* pNode = dirtyNodes_[i];
+
+		int32 x = 0, z = 0;
+		if(pGrid_)
+		{
+			x = pGrid_->toGridPos(pNode->xx());
+			z = pGrid_->toGridPos(pNode->zz());
+		}
+		else
+		{
+			x = (int32)std::max(std::min(pNode->xx(), 32767.f), -32768.f);
+			z = (int32)std::max(std::min(pNode->zz(), 32767.f), -32768.f);
+		}
+
+		x = std::max(std::min(x, 32767), -32768);
+		z = std::max(std::min(z, 32767), -32768);
+
+		sortKeys_[i] = (((uint32)(x + 32768)) << 16) | (uint32)(z + 32768);
+	}
+
+	// LSD ÿδ8λ
+	for(uint32 shift = 0; shift < 32; shift += 8)
+	{
+		size_t counts[257];
+		memset(counts, 0, sizeof(counts));
+
+		for(size_t i = 0; i < count; ++i)
+			++counts[((sortKeys_[i] >> shift) & 0xff) + 1];
+
+		for(size_t i = 0; i < 256; ++i)
+			counts[i + 1] += counts[i];
+
+		for(size_t i = 0; i < count; ++i)
+		{
+			size_t pos = counts[(sortKeys_[i] >> shift) & 0xff]++;
+			sortKeysTmp_[pos] = sortKeys_[i];
+			sortNodes_[pos] = dirtyNodes_[i];
+		}
+
+		sortKeys_.swap(sortKeysTmp_);
+		dirtyNodes_.swap(sortNodes_);
+	}
+
+	for(size_t i = 0; i < count; ++i)
+		dirtyNodes_[i]->dirtyIndex((int32)i);
+
+	sortNodes_.clear();
+}
+
+//-------------------------------------------------------------------------------------
+}
\ No newline at end of file
@@ -27,6 +27,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 namespace KBEngine{
 
 class CoordinateNode;
+class CoordinateGrid;
 
 class CoordinateSystem
 {
@@ -68,7 +69,45 @@ public:
 
 	INLINE uint32 size()const;
 
+	/**
+		ʹþڵ㣬 ֻûнڵʱл
+	*/
+	bool initGrid(float gridSize);
+	INLINE CoordinateGrid* pGrid()const;
+
+	/**
+		xzƽ(x, z)ΪradiusΧڵĽڵ(ģʽ)
+	*/
+	void nodesInRange(std::vector<CoordinateNode*>& nodes, float x, float z, float radius);
+
+	/**
+		ӳٸģʽ½ڵıʱֻ¼ ÿtickͳһһ
+		falseʾҪ
+	*/
+	bool addDirtyNode(CoordinateNode* pNode);
+	void updateDirtyNodes();
+	INLINE size_t dirtyNodesSize()const;
+
 	static bool hasY;
+
+	static bool useGrid;
+	static float gridSize;
+
+	static bool deferredUpdate;
+
+private:
+	/**
+		ģʽµĽڵ, ֻڴڵ֮onNodePassX/Y/Z¼
+	*/
+	void updateGrid(CoordinateNode* pNode);
+
+	void onNodePassGrid(CoordinateNode* pNode, CoordinateNode* pCurrNode, bool isfront);
+
+	/**
+		xzԵȴµĽڵл ʹڵĽڵ
+	*/
+	void sortDirtyNodes();
+
 private:
 	uint32 size_;
 
@@ -81,6 +120,22 @@ private:
 	size_t dels_count_;
 
 	int updating_;
+
+	// ģʽµĿռ ΪNULLʹ
+	CoordinateGrid* pGrid_;
+
+	// ģʽдķΧ
+	float maxRange_xz_;
+
+	// ģʽupdateʱҳڽڵ
+	std::vector<CoordinateNode*> gridNodes_;
+
+	// ӳٸģʽ±tick귢ıĽڵ
+	std::vector<CoordinateNode*> dirtyNodes_;
+	std::vector<CoordinateNode*> sortNodes_;
+	std::vector<uint32> sortKeys_, sortKeysTmp_;
+
+	bool updatingDirtyNodes_;
 };
 
 }
@@ -34,9 +34,18 @@ INLINE CoordinateNode * CoordinateSystem::pFirstZNode()const { return first_z_co
 //-------------------------------------------------------------------------------------
 INLINE uint32 CoordinateSystem::size()const{ return size_; }
 
+//-------------------------------------------------------------------------------------
+INLINE CoordinateGrid* CoordinateSystem::pGrid()const { return pGrid_; }
+
+//-------------------------------------------------------------------------------------
+INLINE size_t CoordinateSystem::dirtyNodesSize()const { return dirtyNodes_.size(); }
+
 //-------------------------------------------------------------------------------------
 INLINE bool CoordinateSystem::isEmpty()const 
 { 
+	if(pGrid_)
+		return size_ == 0;
+
 	return first_x_coordinateNode_ == NULL && first_y_coordinateNode_ == NULL && first_z_coordinateNode_ == NULL;
 }
 
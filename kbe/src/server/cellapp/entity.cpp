@@ -107,6 +107,7 @@ direction_(),
 pPyDirection_(NULL),
 posChangedTime_(0),
 dirChangedTime_(0),
+volatileDataCache_(),
 isOnGround_(false),
 topSpeed_(-0.1f),
 topSpeedY_(-0.1f),
@@ -161,7 +162,10 @@ Entity::~Entity()
 void Entity::installCoordinateNodes(CoordinateSystem* pCoordinateSystem)
 {
 	if(g_kbeSrvConfig.getCellApp().use_coordinate_system)
+	{
+		pEntityCoordinateNode()->syncPosition();
 		pCoordinateSystem->insert((KBEngine::CoordinateNode*)pEntityCoordinateNode());
+	}
 }
 
 //-------------------------------------------------------------------------------------
@@ -384,6 +388,20 @@ PyObject* Entity::onScriptGetAttribute(PyObject* attr)
 	return ScriptObject::onScriptGetAttribute(attr);
 }	
 
+//-------------------------------------------------------------------------------------
+MemoryStream* Entity::createClientPropertyStream(const PropertyDescription* propertyDescription, MemoryStream* mstream)
+{
+	MemoryStream* s = MemoryStream::ObjPool().createObject();
+
+	if(scriptModule_->usePropertyDescrAlias())
+		(*s) << propertyDescription->aliasIDAsUint8();
+	else
+		(*s) << propertyDescription->getUType();
+
+	s->append(*mstream);
+	return s;
+}
+
 //-------------------------------------------------------------------------------------
 void Entity::onDefDataChanged(const PropertyDescription* propertyDescription, PyObject* pyData)
 {
@@ -430,6 +448,9 @@ void Entity::onDefDataChanged(const PropertyDescription* propertyDescription, Py
 	{
 		DETAIL_TYPE propertyDetailLevel = propertyDescription->getDetailLevel();
 
+		// IDֵй۲߶ͬ ֻлһΣ ÿ۲ֻдԵϢͷ
+		MemoryStream* pClientStream = NULL;
+
 		std::list<ENTITY_ID>::iterator witer = witnesses_.begin();
 		for(; witer != witnesses_.end(); witer++)
 		{
@@ -453,30 +474,24 @@ void Entity::onDefDataChanged(const PropertyDescription* propertyDescription, Py
 
 			if(scriptModule_->getDetailLevel().level[propertyDetailLevel].inLevel(lengthPos.length()))
 			{
-				Mercury::Bundle* pForwardBundle = Mercury::Bundle::ObjPool().createObject();
-
-				pEntity->pWitness()->addSmartAOIEntityMessageToBundle(pForwardBundle, ClientInterface::onUpdatePropertys, 
-					ClientInterface::onUpdatePropertysOptimized, getID());
+				if(pClientStream == NULL)
+					pClientStream = createClientPropertyStream(propertyDescription, mstream);
 
-				if(scriptModule_->usePropertyDescrAlias())
-					(*pForwardBundle) << propertyDescription->aliasIDAsUint8();
-				else
-					(*pForwardBundle) << propertyDescription->getUType();
-
-				pForwardBundle->append(*mstream);
+				int32 msgLength = pEntity->pWitness()->sendEntityMessageToClient(ClientInterface::onUpdatePropertys, 
+					ClientInterface::onUpdatePropertysOptimized, getID(), *pClientStream);
 				
 				// ¼¼С
-				g_publicClientEventHistoryStats.trackEvent(getScriptName(), 
-					propertyDescription->getName(), 
-					pForwardBundle->currMsgLength());
-
-				Mercury::Bundle* pSendBundle = Mercury::Bundle::ObjPool().createObject();
-				MERCURY_ENTITY_MESSAGE_FORWARD_CLIENT(pEntity->getID(), (*pSendBundle), (*pForwardBundle));
-
-				pEntity->pWitness()->sendToClient(ClientInterface::onUpdatePropertysOptimized, pSendBundle);
-				Mercury::Bundle::ObjPool().reclaimObject(pForwardBundle);
+				if(msgLength > 0)
+				{
+					g_publicClientEventHistoryStats.trackEvent(getScriptName(), 
+						propertyDescription->getName(), 
+						msgLength);
+				}
 			}
 		}
+
+		if(pClientStream)
+			MemoryStream::ObjPool().reclaimObject(pClientStream);
 	}
 
 	/*
@@ -537,30 +552,21 @@ void Entity::onDefDataChanged(const PropertyDescription* propertyDescription, Py
 	// жǷҪ㲥ԼĿͻ
 	if((flags & ENTITY_BROADCAST_OWN_CLIENT_FLAGS) > 0 && clientMailbox_ != NULL && pWitness_)
 	{
-		Mercury::Bundle* pForwardBundle = Mercury::Bundle::ObjPool().createObject();
-		(*pForwardBundle).newMessage(ClientInterface::onUpdatePropertys);
-		(*pForwardBundle) << getID();
+		MemoryStream* pClientStream = createClientPropertyStream(propertyDescription, mstream);
 
-		if(scriptModule_->usePropertyDescrAlias())
-			(*pForwardBundle) << propertyDescription->aliasIDAsUint8();
-		else
-			(*pForwardBundle) << propertyDescription->getUType();
+		// ԼĿͻʹentityID
+		int32 msgLength = pWitness_->sendEntityMessageToClient(ClientInterface::onUpdatePropertys, 
+			ClientInterface::onUpdatePropertys, getID(), *pClientStream);
 
-		pForwardBundle->append(*mstream);
+		MemoryStream::ObjPool().reclaimObject(pClientStream);
 		
 		// ¼¼С
-		if((flags & ENTITY_BROADCAST_OTHER_CLIENT_FLAGS) <= 0)
+		if((flags & ENTITY_BROADCAST_OTHER_CLIENT_FLAGS) <= 0 && msgLength > 0)
 		{
 			g_privateClientEventHistoryStats.trackEvent(getScriptName(), 
 				propertyDescription->getName(), 
-				pForwardBundle->currMsgLength());
+				msgLength);
 		}
-
-		Mercury::Bundle* pSendBundle = Mercury::Bundle::ObjPool().createObject();
-		MERCURY_ENTITY_MESSAGE_FORWARD_CLIENT(getID(), (*pSendBundle), (*pForwardBundle));
-
-		pWitness_->sendToClient(ClientInterface::onUpdatePropertys, pSendBundle);
-		Mercury::Bundle::ObjPool().reclaimObject(pForwardBundle);
 	}
 
 	MemoryStream::ObjPool().reclaimObject(mstream);
@@ -1299,6 +1305,8 @@ void Entity::onPositionChanged()
 		return;
 
 	posChangedTime_ = g_kbetime;
+	clearVolatileDataCache();
+
 	if(this->pEntityCoordinateNode())
 		this->pEntityCoordinateNode()->update();
 
@@ -1318,6 +1326,8 @@ void Entity::onPyDirectionChanged()
 		return;
 
 	// onDirectionChanged();
+	clearVolatileDataCache();
+
 	static ENTITY_PROPERTY_UID diruid = 0;
 	if(diruid == 0)
 	{
@@ -1341,6 +1351,7 @@ void Entity::onDirectionChanged()
 		return;
 
 	dirChangedTime_ = g_kbetime;
+	clearVolatileDataCache();
 }
 
 //-------------------------------------------------------------------------------------
@@ -67,6 +67,32 @@ class Bundle;
 typedef SmartPointer<Entity> EntityPtr;
 typedef std::vector<EntityPtr> SPACE_ENTITIES;
 
+/**
+	witness¿ͻʱʹõvolatileݻ
+	ı͸±־й۲߶ͬ ÿtickֻһ
+*/
+struct VolatileDataCache
+{
+	VolatileDataCache():
+	time(0xffffffff),
+	updatePosition(false),
+	dirFlags(0),
+	dirSize(0)
+	{
+	}
+
+	// ʱ(g_kbetime)
+	GAME_TIME time;
+
+	// ǷҪλ
+	bool updatePosition;
+
+	// 򲿷ֵĸ±־ѱ
+	uint32 dirFlags;
+	uint8 dirSize;
+	int8 dirData[3];
+};
+
 class Entity : public script::ScriptObject
 {
 	/** ໯ һЩpy */
@@ -114,6 +140,12 @@ public:
 	*/
 	void onDefDataChanged(const PropertyDescription* propertyDescription, 
 			PyObject* pyData);
+
+	/** 
+		ͻ˵(ID + ֵ) ɵ߻
+	*/
+	MemoryStream* createClientPropertyStream(const PropertyDescription* propertyDescription, 
+			MemoryStream* mstream);
 	
 	/** 
 		entityͨͨ
@@ -500,6 +532,12 @@ public:
 	INLINE GAME_TIME posChangedTime()const;
 	INLINE GAME_TIME dirChangedTime()const;
 
+	/**
+		witnessʹõvolatileݻ棬 λóıʱʧЧ
+	*/
+	INLINE VolatileDataCache& volatileDataCache();
+	INLINE void clearVolatileDataCache();
+
 	/** 
 		realԵghost
 	*/
@@ -572,6 +610,9 @@ protected:
 	GAME_TIME												posChangedTime_;
 	GAME_TIME												dirChangedTime_;
 
+	// witnessʹõvolatileݻ
+	VolatileDataCache										volatileDataCache_;
+
 	// Ƿڵ
 	bool													isOnGround_;						
 
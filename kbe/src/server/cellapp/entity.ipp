@@ -253,6 +253,18 @@ INLINE GAME_TIME Entity::dirChangedTime()const
 	return dirChangedTime_;
 }
 
+//-------------------------------------------------------------------------------------
+INLINE VolatileDataCache& Entity::volatileDataCache()
+{
+	return volatileDataCache_;
+}
+
+//-------------------------------------------------------------------------------------
+INLINE void Entity::clearVolatileDataCache()
+{
+	volatileDataCache_.time = 0xffffffff;
+}
+
 //-------------------------------------------------------------------------------------
 INLINE int8 Entity::layer()const
 {
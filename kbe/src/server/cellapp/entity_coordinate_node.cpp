@@ -19,6 +19,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "entity_coordinate_node.hpp"
+#include "coordinate_system.hpp"
 #include "entity.hpp"
 
 namespace KBEngine{	
@@ -28,7 +29,8 @@ namespace KBEngine{
 EntityCoordinateNode::EntityCoordinateNode(Entity* pEntity):
 CoordinateNode(NULL),
 pEntity_(pEntity),
-watcherNodes_()
+watcherNodes_(),
+syncedPosition_()
 {
 	flags(COORDINATE_NODE_FLAG_ENTITY);
 
@@ -49,6 +51,9 @@ float EntityCoordinateNode::xx()const
 	if(pEntity_ == NULL || (flags() & (COORDINATE_NODE_FLAG_REMOVED | COORDINATE_NODE_FLAG_REMOVEING)) > 0)
 		return -FLT_MAX;
 
+	if(CoordinateSystem::deferredUpdate)
+		return syncedPosition_.x;
+
 	return pEntity_->getPosition().x;
 }
 
@@ -58,6 +63,9 @@ float EntityCoordinateNode::yy()const
 	if(pEntity_ == NULL)
 		return -FLT_MAX;
 
+	if(CoordinateSystem::deferredUpdate)
+		return syncedPosition_.y;
+
 	return pEntity_->getPosition().y;
 }
 
@@ -67,12 +75,20 @@ float EntityCoordinateNode::zz()const
 	if(pEntity_ == NULL)
 		return -FLT_MAX;
 
+	if(CoordinateSystem::deferredUpdate)
+		return syncedPosition_.z;
+
 	return pEntity_->getPosition().z;
 }
 
 //-------------------------------------------------------------------------------------
 void EntityCoordinateNode::update()
 {
+	// ӳٸģʽֻǣ CoordinateSystem::updateDirtyNodesͳһ
+	if(pCoordinateSystem_ && pCoordinateSystem_->addDirtyNode(this))
+		return;
+
+	syncPosition();
 	CoordinateNode::update();
 	std::vector<CoordinateNode*>::iterator iter = watcherNodes_.begin();
 	for(; iter != watcherNodes_.end(); iter++)
@@ -81,6 +97,13 @@ void EntityCoordinateNode::update()
 	}
 }
 
+//-------------------------------------------------------------------------------------
+void EntityCoordinateNode::syncPosition()
+{
+	if(pEntity_)
+		syncedPosition_ = pEntity_->getPosition();
+}
+
 //-------------------------------------------------------------------------------------
 void EntityCoordinateNode::onRemove()
 {
@@ -119,6 +142,34 @@ bool EntityCoordinateNode::delWatcherNode(CoordinateNode* pNode)
 void EntityCoordinateNode::entitiesInRange(std::vector<Entity*>& findentities, CoordinateNode* rootNode, 
 									  const Position3D& originpos, float radius, int entityUType)
 {
+	CoordinateSystem* pCoordinateSystem = rootNode->pCoordinateSystem();
+	if(pCoordinateSystem && pCoordinateSystem->pGrid())
+	{
+		std::vector<CoordinateNode*> nodes;
+		pCoordinateSystem->nodesInRange(nodes, originpos.x, originpos.z, radius);
+
+		std::vector<CoordinateNode*>::iterator iter = nodes.begin();
+		for(; iter != nodes.end(); iter++)
+		{
+			if(((*iter)->flags() & COORDINATE_NODE_FLAG_ENTITY) <= 0)
+				continue;
+
+			Entity* pEntity = static_cast<EntityCoordinateNode*>((*iter))->pEntity();
+			if(entityUType == -1 || pEntity->getScriptModule()->getUType() == (ENTITY_SCRIPT_UID)entityUType)
+			{
+				Position3D distVec = originpos - pEntity->getPosition();
+				float dist = KBEVec3Length(&distVec);
+
+				if(dist <= radius)
+				{
+					findentities.push_back(pEntity);
+				}
+			}
+		}
+
+		return;
+	}
+
 	if((rootNode->flags() & COORDINATE_NODE_FLAG_ENTITY) > 0)
 	{
 		Entity* pEntity = static_cast<EntityCoordinateNode*>(rootNode)->pEntity();
@@ -44,6 +44,12 @@ public:
 
 	virtual void update();
 
+	/**
+		ӳٸģʽϵͳʹõһθʱ¼꣬ 
+		֤ͬһtickڶʵȺʱһµλ
+	*/
+	void syncPosition();
+
 	Entity* pEntity()const { return pEntity_; }
 	void pEntity(Entity* pEntity) { pEntity_ = pEntity; }
 
@@ -58,6 +64,8 @@ protected:
 	Entity* pEntity_;
 
 	std::vector<CoordinateNode*> watcherNodes_;
+
+	Position3D syncedPosition_;
 };
 
 }
@@ -28,7 +28,9 @@ namespace KBEngine{
 EntityRef::EntityRef(Entity* pEntity):
 id_(0),
 pEntity_(pEntity),
-flags_(ENTITYREF_FLAG_UNKONWN)
+flags_(ENTITYREF_FLAG_UNKONWN),
+aliasID_(0),
+priority_(0.f)
 {
 	id_ = pEntity->getID();
 }
@@ -37,7 +39,9 @@ flags_(ENTITYREF_FLAG_UNKONWN)
 EntityRef::EntityRef():
 id_(0),
 pEntity_(NULL),
-flags_(ENTITYREF_FLAG_UNKONWN)
+flags_(ENTITYREF_FLAG_UNKONWN),
+aliasID_(0),
+priority_(0.f)
 {
 }
 
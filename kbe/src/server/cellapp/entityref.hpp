@@ -38,6 +38,7 @@ class EntityRef
 {
 public:
 	typedef std::vector<EntityRef*> AOI_ENTITIES;
+	typedef KBEUnordered_map<ENTITY_ID, EntityRef*> AOI_ENTITIES_MAP;
 
 	EntityRef(Entity* pEntity);
 	EntityRef();
@@ -53,12 +54,26 @@ public:
 
 	ENTITY_ID id()const{ return id_; }
 
+	/**
+		witnessaoiEntitiesеλã ͻʹΪentityıID
+	*/
+	void aliasID(uint32 v){ aliasID_ = v; }
+	uint32 aliasID()const{ return aliasID_; }
+
+	/**
+		witness¸entityȼ ֵԽСԽ
+	*/
+	void priority(float v){ priority_ = v; }
+	float priority()const{ return priority_; }
+
 	void addToStream(KBEngine::MemoryStream& s);
 	void createFromStream(KBEngine::MemoryStream& s);
 private:
 	ENTITY_ID id_;
 	Entity* pEntity_;
 	uint32 flags_;
+	uint32 aliasID_;
+	float priority_;
 };
 
 class Entity;
@@ -73,6 +88,20 @@ private:
 	Entity* obj_;
 };
 
+class entityref_index_priority_greater
+{
+public:
+	entityref_index_priority_greater(const EntityRef::AOI_ENTITIES& entityRefs)
+	: entityRefs_(entityRefs) {}
+
+	bool operator()(uint32 a, uint32 b)const
+	{
+		return entityRefs_[a]->priority() > entityRefs_[b]->priority();
+	}
+private:
+	const EntityRef::AOI_ENTITIES& entityRefs_;
+};
+
 class findif_vector_entityref_exist_by_entityid_handler
 {
 public:
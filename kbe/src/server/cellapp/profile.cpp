@@ -25,6 +25,7 @@ ProfileVal SCRIPTCALL_PROFILE("scriptCall");
 ProfileVal ONMOVE_PROFILE("onMove");
 ProfileVal ON_NAVIGATE_PROFILE( "onNavigate" );
 ProfileVal CLIENT_UPDATE_PROFILE( "clientUpdate" );
+ProfileVal UPDATABLES_PROFILE( "updatables" );
 
 EventHistoryStats g_privateClientEventHistoryStats("PrivateClientEvents");
 EventHistoryStats g_publicClientEventHistoryStats("PublicClientEvents");
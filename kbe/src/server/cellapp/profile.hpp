@@ -32,6 +32,7 @@ extern ProfileVal SCRIPTCALL_PROFILE;
 extern ProfileVal ONMOVE_PROFILE;
 extern ProfileVal ONNAVIGATE_PROFILE;
 extern ProfileVal CLIENT_UPDATE_PROFILE;
+extern ProfileVal UPDATABLES_PROFILE;
 
 
 extern EventHistoryStats g_privateClientEventHistoryStats;
@@ -61,6 +61,8 @@ bool RangeTrigger::install()
 	else
 		positiveBoundary_->range(0.0f, 0.0f);
 
+	positiveBoundary_->flags(positiveBoundary_->flags() | COORDINATE_NODE_FLAG_POSITIVE_BOUNDARY);
+
 	if(negativeBoundary_ == NULL)
 		negativeBoundary_ = new RangeTriggerNode(this, 0, 0);
 	else
@@ -35,7 +35,7 @@ old_range_xz_(range_xz_),
 old_range_y_(range_y_),
 pRangeTrigger_(pRangeTrigger)
 {
-	flags(COORDINATE_NODE_FLAG_HIDE);
+	flags(COORDINATE_NODE_FLAG_HIDE | COORDINATE_NODE_FLAG_TRIGGER);
 
 #ifdef _DEBUG
 	descr((boost::format("RangeTriggerNode(origin=%1%->%2%)") % pRangeTrigger_->origin() % pRangeTrigger_->origin()->descr()).str());
@@ -57,6 +57,12 @@ void RangeTriggerNode::onParentRemove(CoordinateNode* pParentNode)
 		pParentNode->pCoordinateSystem()->remove(this);
 }
 
+//-------------------------------------------------------------------------------------
+float RangeTriggerNode::range_xz()const
+{
+	return range_xz_;
+}
+
 //-------------------------------------------------------------------------------------
 float RangeTriggerNode::xx()const 
 {
@@ -36,7 +36,7 @@ public:
 
 	INLINE void range(float xz, float y);
 	INLINE void old_range(float xz, float y);
-	INLINE float range_xz()const;
+	virtual float range_xz()const;
 	INLINE float range_y()const;
 
 	INLINE RangeTrigger* pRangeTrigger()const;
@@ -85,12 +85,6 @@ INLINE void RangeTriggerNode::old_range(float xz, float y)
 	old_range_y_ = y;
 }
 
-//-------------------------------------------------------------------------------------
-INLINE float RangeTriggerNode::range_xz()const
-{
-	return range_xz_;
-}
-
 //-------------------------------------------------------------------------------------
 INLINE float RangeTriggerNode::range_y()const
 {
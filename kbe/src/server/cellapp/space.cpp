@@ -45,6 +45,8 @@ coordinateSystem_(),
 pNavHandle_(),
 destroyed_(false)
 {
+	if(CoordinateSystem::useGrid)
+		coordinateSystem_.initGrid(CoordinateSystem::gridSize);
 }
 
 //-------------------------------------------------------------------------------------
@@ -203,6 +205,8 @@ void Space::onAllSpaceGeometryLoaded()
 //-------------------------------------------------------------------------------------
 void Space::update()
 {
+	coordinateSystem_.updateDirtyNodes();
+
 	if(pNavHandle_ == NULL)
 		return;
 }
@@ -26,7 +26,7 @@ namespace KBEngine {
 
 int32 watchWitnessPool_size()
 {
-	return (int)Witness::ObjPool().objects().size();
+	return (int)Witness::ObjPool().size();
 }
 
 int32 watchWitnessPool_max()
@@ -46,15 +46,22 @@ bool watchWitnessPool_isDestroyed()
 
 uint32 watchWitnessPool_bytes()
 {
-	size_t bytes = 0;
+	return (uint32)Witness::ObjPool().bytes();
+}
 
-	ObjectPool<Witness>::OBJECTS::const_iterator iter = Witness::ObjPool().objects().begin();
-	for(; iter != Witness::ObjPool().objects().end(); iter++)
-	{
-		bytes += static_cast<PoolObject*>((*iter))->getPoolObjectBytes();
-	}
+uint32 watchWitnessPool_hits()
+{
+	return (uint32)Witness::ObjPool().hits();
+}
 
-	return (uint32)bytes;
+uint32 watchWitnessPool_misses()
+{
+	return (uint32)Witness::ObjPool().misses();
+}
+
+uint32 watchWitnessPool_peakAlloc()
+{
+	return (uint32)Witness::ObjPool().peakAlloc();
 }
 
 //-------------------------------------------------------------------------------------
@@ -65,6 +72,9 @@ bool WatchObjectPool::initWatchPools()
 	WATCH_OBJECT("objectPools/Witness/isDestroyed", &watchWitnessPool_isDestroyed);
 	WATCH_OBJECT("objectPools/Witness/memory", &watchWitnessPool_bytes);
 	WATCH_OBJECT("objectPools/Witness/totalAllocs", &watchWitnessPool_totalAlloc);
+	WATCH_OBJECT("objectPools/Witness/hits", &watchWitnessPool_hits);
+	WATCH_OBJECT("objectPools/Witness/misses", &watchWitnessPool_misses);
+	WATCH_OBJECT("objectPools/Witness/peakAlloc", &watchWitnessPool_peakAlloc);
 	return true;
 }
 
@@ -23,8 +23,11 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "profile.hpp"
 #include "cellapp.hpp"
 #include "aoi_trigger.hpp"
+#include "coordinate_system.hpp"
+#include "entity_coordinate_node.hpp"
 #include "network/channel.hpp"	
 #include "network/bundle.hpp"
+#include "network/mercurystats.hpp"
 #include "math/math.hpp"
 #include "client_lib/client_interface.hpp"
 
@@ -56,7 +59,16 @@ aoiRadius_(0.0f),
 aoiHysteresisArea_(5.0f),
 pAOITrigger_(NULL),
 aoiEntities_(),
-clientAOISize_(0)
+aoiEntitiesMap_(),
+clientAOISize_(0),
+updateQueue_(),
+updateHeap_(),
+updatePosX_(),
+updatePosY_(),
+updatePosZ_(),
+packedXZ_(),
+packedY_(),
+updateStream_()
 {
 }
 
@@ -94,7 +106,7 @@ void Witness::createFromStream(KBEngine::MemoryStream& s)
 	{
 		EntityRef* pEntityRef = new EntityRef();
 		pEntityRef->createFromStream(s);
-		aoiEntities_.push_back(pEntityRef);
+		_addAOIEntityRef(pEntityRef);
 	}
 
 	if(g_kbeSrvConfig.getCellApp().use_coordinate_system)
@@ -194,16 +206,7 @@ void Witness::clear(Entity* pEntity)
 {
 	KBE_ASSERT(pEntity == pEntity_);
 
-	EntityRef::AOI_ENTITIES::iterator iter = aoiEntities_.begin();
-	for(; iter != aoiEntities_.end(); iter++)
-	{
-		if((*iter)->pEntity())
-		{
-			(*iter)->pEntity()->delWitnessed(pEntity_);
-		}
-
-		delete (*iter);
-	}
+	_clearAOIEntityRefs();
 	
 	pEntity_ = NULL;
 	aoiRadius_ = 0.0f;
@@ -211,8 +214,6 @@ void Witness::clear(Entity* pEntity)
 	clientAOISize_ = 0;
 	SAFE_RELEASE(pAOITrigger_);
 
-	aoiEntities_.clear();
-
 	Cellapp::getSingleton().removeUpdatable(this);
 }
 
@@ -271,18 +272,22 @@ void Witness::setAoiRadius(float radius, float hyst)
 //-------------------------------------------------------------------------------------
 void Witness::onEnterAOI(Entity* pEntity)
 {
-	EntityRef::AOI_ENTITIES::iterator iter = std::find_if(aoiEntities_.begin(), aoiEntities_.end(), 
-		findif_vector_entityref_exist_by_entity_handler(pEntity));
+	EntityRef* pEntityRef = getAOIEntityRef(pEntity->getID());
 
-	if(iter != aoiEntities_.end())
+	if(pEntityRef)
 	{
-		if(((*iter)->flags() & ENTITYREF_FLAG_LEAVE_CLIENT_PENDING) > 0)
+		if((pEntityRef->flags() & ENTITYREF_FLAG_LEAVE_CLIENT_PENDING) > 0)
 		{
 			DEBUG_MSG(boost::format("Witness::onEnterAOI: %1% entity=%2%\n") % 
 				pEntity_->getID() % pEntity->getID());
 
-			(*iter)->removeflags(ENTITYREF_FLAG_LEAVE_CLIENT_PENDING);
-			(*iter)->pEntity(pEntity);
+			pEntityRef->removeflags(ENTITYREF_FLAG_LEAVE_CLIENT_PENDING);
+
+			// ͻ˻δentity Ҫ߽
+			if((pEntityRef->flags() & ENTITYREF_FLAG_NORMAL) <= 0)
+				pEntityRef->flags(pEntityRef->flags() | ENTITYREF_FLAG_ENTER_CLIENT_PENDING);
+
+			pEntityRef->pEntity(pEntity);
 			pEntity->addWitnessed(pEntity_);
 		}
 
@@ -292,9 +297,9 @@ void Witness::onEnterAOI(Entity* pEntity)
 	DEBUG_MSG(boost::format("Witness::onEnterAOI: %1% entity=%2%\n") % 
 		pEntity_->getID() % pEntity->getID());
 	
-	EntityRef* pEntityRef = new EntityRef(pEntity);
+	pEntityRef = new EntityRef(pEntity);
 	pEntityRef->flags(pEntityRef->flags() | ENTITYREF_FLAG_ENTER_CLIENT_PENDING);
-	aoiEntities_.push_back(pEntityRef);
+	_addAOIEntityRef(pEntityRef);
 
 	pEntity->addWitnessed(pEntity_);
 }
@@ -302,13 +307,12 @@ void Witness::onEnterAOI(Entity* pEntity)
 //-------------------------------------------------------------------------------------
 void Witness::onLeaveAOI(Entity* pEntity)
 {
-	EntityRef::AOI_ENTITIES::iterator iter = std::find_if(aoiEntities_.begin(), aoiEntities_.end(), 
-		findif_vector_entityref_exist_by_entityid_handler(pEntity->getID()));
+	EntityRef* pEntityRef = getAOIEntityRef(pEntity->getID());
 
-	if(iter == aoiEntities_.end())
+	if(pEntityRef == NULL)
 		return;
 
-	_onLeaveAOI((*iter));
+	_onLeaveAOI(pEntityRef);
 }
 
 //-------------------------------------------------------------------------------------
@@ -329,6 +333,53 @@ void Witness::_onLeaveAOI(EntityRef* pEntityRef)
 	pEntityRef->pEntity(NULL);
 }
 
+//-------------------------------------------------------------------------------------
+void Witness::_addAOIEntityRef(EntityRef* pEntityRef)
+{
+	KBE_ASSERT(aoiEntitiesMap_.find(pEntityRef->id()) == aoiEntitiesMap_.end());
+
+	pEntityRef->aliasID(aoiEntities_.size());
+	aoiEntities_.push_back(pEntityRef);
+	aoiEntitiesMap_[pEntityRef->id()] = pEntityRef;
+}
+
+//-------------------------------------------------------------------------------------
+EntityRef::AOI_ENTITIES::iterator Witness::_delAOIEntityRef(EntityRef::AOI_ENTITIES::iterator iter)
+{
+	EntityRef* pEntityRef = (*iter);
+	aoiEntitiesMap_.erase(pEntityRef->id());
+	delete pEntityRef;
+
+	// ͻ˵ıIDentityбеλã ɾʱ뱣˳ entityλǰ
+	iter = aoiEntities_.erase(iter);
+
+	EntityRef::AOI_ENTITIES::iterator iter1 = iter;
+	for(; iter1 != aoiEntities_.end(); iter1++)
+	{
+		(*iter1)->aliasID((*iter1)->aliasID() - 1);
+	}
+
+	return iter;
+}
+
+//-------------------------------------------------------------------------------------
+void Witness::_clearAOIEntityRefs()
+{
+	EntityRef::AOI_ENTITIES::iterator iter = aoiEntities_.begin();
+	for(; iter != aoiEntities_.end(); iter++)
+	{
+		if((*iter)->pEntity())
+		{
+			(*iter)->pEntity()->delWitnessed(pEntity_);
+		}
+
+		delete (*iter);
+	}
+
+	aoiEntities_.clear();
+	aoiEntitiesMap_.clear();
+}
+
 //-------------------------------------------------------------------------------------
 void Witness::onEnterSpace(Space* pSpace)
 {
@@ -384,18 +435,7 @@ void Witness::onLeaveSpace(Space* pSpace)
 
 	lastBasePos.z = -FLT_MAX;
 
-	EntityRef::AOI_ENTITIES::iterator iter = aoiEntities_.begin();
-	for(; iter != aoiEntities_.end(); iter++)
-	{
-		if((*iter)->pEntity())
-		{
-			(*iter)->pEntity()->delWitnessed(pEntity_);
-		}
-
-		delete (*iter);
-	}
-
-	aoiEntities_.clear();
+	_clearAOIEntityRefs();
 }
 
 //-------------------------------------------------------------------------------------
@@ -536,25 +576,20 @@ void Witness::addSmartAOIEntityMessageToBundle(Mercury::Bundle* pBundle, const M
 bool Witness::entityID2AliasID(ENTITY_ID id, uint8& aliasID)const
 {
 	aliasID = 0;
-	EntityRef::AOI_ENTITIES::const_iterator iter = aoiEntities_.begin();
-	for(; iter != aoiEntities_.end(); iter++)
-	{
-		EntityRef* pEntityRef = (*iter);
-		if(pEntityRef->id() == id)
-		{
-			if((pEntityRef->flags() & (ENTITYREF_FLAG_NORMAL)) <= 0)
-				return false;
 
-			break;
-		}
-		
-		// Ҫ
-		if(aliasID == 255)
-			return false;
-		
-		++aliasID;
-	}
+	EntityRef::AOI_ENTITIES_MAP::const_iterator iter = aoiEntitiesMap_.find(id);
+	if(iter == aoiEntitiesMap_.end())
+		return false;
+
+	EntityRef* pEntityRef = iter->second;
+	if((pEntityRef->flags() & (ENTITYREF_FLAG_NORMAL)) <= 0)
+		return false;
 
+	// Ҫ
+	if(pEntityRef->aliasID() > 255)
+		return false;
+
+	aliasID = (uint8)pEntityRef->aliasID();
 	return true;
 }
 
@@ -569,6 +604,10 @@ bool Witness::update()
 	Mercury::Channel* pChannel = pEntity_->getClientMailbox()->getChannel();
 	if(!pChannel)
 		return true;
+
+	// tickи类µĶ(ƶ)ƶʵ壬 ȱ֤AOIµ
+	if(pEntity_->pEntityCoordinateNode() && pEntity_->pEntityCoordinateNode()->pCoordinateSystem())
+		pEntity_->pEntityCoordinateNode()->pCoordinateSystem()->updateDirtyNodes();
 	
 	// ȡÿ֡ʣдС ȸµд룬 ʣһڵ
 	int remainPacketSize = PACKET_MAX_SIZE_TCP - pChannel->bundlesLength();
@@ -580,8 +619,17 @@ bool Witness::update()
 			Mercury::Bundle* pSendBundle = NEW_BUNDLE();
 
 			MERCURY_ENTITY_MESSAGE_FORWARD_CLIENT_START(pEntity_->getID(), (*pSendBundle));
+
+			// λֻڱ仯ʱŷͣ ʧͻ˽λûһֱ ˺ͽAOIһ߿ɿͨ
 			addBasePosToStream(pSendBundle);
 
+			// ʵĳλóµ ͻʹÿɿUDPʱⲿֶʧش
+			// ڵλ
+			Mercury::Bundle* pVolatileBundle = NEW_BUNDLE();
+			MERCURY_ENTITY_MESSAGE_FORWARD_CLIENT_VOLATILE_START(pEntity_->getID(), (*pVolatileBundle));
+
+			float minPriority = 0.f;
+
 			EntityRef::AOI_ENTITIES::iterator iter = aoiEntities_.begin();
 			for(; iter != aoiEntities_.end(); )
 			{
@@ -596,39 +644,25 @@ bool Witness::update()
 					{
 						(*iter)->pEntity(NULL);
 						_onLeaveAOI((*iter));
-						delete (*iter);
-						iter = aoiEntities_.erase(iter);
+						iter = _delAOIEntityRef(iter);
 						continue;
 					}
 					
 					(*iter)->removeflags(ENTITYREF_FLAG_ENTER_CLIENT_PENDING);
 
-					Mercury::Bundle* pForwardBundle1 = Mercury::Bundle::ObjPool().createObject();
-					Mercury::Bundle* pForwardBundle2 = Mercury::Bundle::ObjPool().createObject();
-
-					MemoryStream* s1 = MemoryStream::ObjPool().createObject();
-					otherEntity->addPositionAndDirectionToStream(*s1, true);			
-					otherEntity->addClientDataToStream(s1, true);
-
-					(*pForwardBundle1).newMessage(ClientInterface::onUpdatePropertys);
-					(*pForwardBundle1) << otherEntity->getID();
-					(*pForwardBundle1).append(*s1);
-					MemoryStream::ObjPool().reclaimObject(s1);
+					updateStream_.clear(false);
+					updateStream_ << otherEntity->getID();
+					otherEntity->addPositionAndDirectionToStream(updateStream_, true);			
+					otherEntity->addClientDataToStream(&updateStream_, true);
+					remainPacketSize -= _addMessageToBundle(pSendBundle, ClientInterface::onUpdatePropertys, updateStream_);
 			
-					(*pForwardBundle2).newMessage(ClientInterface::onEntityEnterWorld);
-					(*pForwardBundle2) << otherEntity->getID();
-					otherEntity->getScriptModule()->addSmartUTypeToBundle(pForwardBundle2);
+					updateStream_.clear(false);
+					updateStream_ << otherEntity->getID();
+					otherEntity->getScriptModule()->addSmartUTypeToStream(&updateStream_);
 					if(!otherEntity->isOnGround())
-						(*pForwardBundle2) << otherEntity->isOnGround();
-
-					MERCURY_ENTITY_MESSAGE_FORWARD_CLIENT_APPEND((*pSendBundle), (*pForwardBundle1));
-					MERCURY_ENTITY_MESSAGE_FORWARD_CLIENT_APPEND((*pSendBundle), (*pForwardBundle2));
-					
-					remainPacketSize -= pForwardBundle1->packetsLength();
-					remainPacketSize -= pForwardBundle2->packetsLength();
+						updateStream_ << otherEntity->isOnGround();
 
-					Mercury::Bundle::ObjPool().reclaimObject(pForwardBundle1);
-					Mercury::Bundle::ObjPool().reclaimObject(pForwardBundle2);
+					remainPacketSize -= _addMessageToBundle(pSendBundle, ClientInterface::onEntityEnterWorld, updateStream_);
 
 					(*iter)->flags(ENTITYREF_FLAG_NORMAL);
 					
@@ -642,19 +676,14 @@ bool Witness::update()
 
 					if(((*iter)->flags() & ENTITYREF_FLAG_NORMAL) > 0)
 					{
-						Mercury::Bundle* pForwardBundle = Mercury::Bundle::ObjPool().createObject();
-
-						(*pForwardBundle).newMessage(ClientInterface::onEntityLeaveWorldOptimized);
-						_addAOIEntityIDToBundle(pForwardBundle, (*iter)->id());
-
-						MERCURY_ENTITY_MESSAGE_FORWARD_CLIENT_APPEND((*pSendBundle), (*pForwardBundle));
-						Mercury::Bundle::ObjPool().reclaimObject(pForwardBundle);
+						updateStream_.clear(false);
+						_addAOIEntityIDToStream(&updateStream_, (*iter));
+						_addMessageToBundle(pSendBundle, ClientInterface::onEntityLeaveWorldOptimized, updateStream_);
 
 						--clientAOISize_;
 					}
 
-					delete (*iter);
-					iter = aoiEntities_.erase(iter);
+					iter = _delAOIEntityRef(iter);
 					continue;
 				}
 				else
@@ -662,47 +691,91 @@ bool Witness::update()
 					Entity* otherEntity = (*iter)->pEntity();
 					if(otherEntity == NULL)
 					{
-						delete (*iter);
-						iter = aoiEntities_.erase(iter);
+						iter = _delAOIEntityRef(iter);
 						continue;
 					}
 					
 					KBE_ASSERT((*iter)->flags() == ENTITYREF_FLAG_NORMAL);
 
-					Mercury::Bundle* pForwardBundle = Mercury::Bundle::ObjPool().createObject();
-					MemoryStream* s1 = MemoryStream::ObjPool().createObject();
-					
-					addUpdateHeadToStream(pForwardBundle, addEntityVolatileDataToStream(s1, otherEntity), (*iter));
-
-					(*pForwardBundle).append(*s1);
-					MemoryStream::ObjPool().reclaimObject(s1);
-					
-					if(pForwardBundle->packetsLength() > 0)
-					{
-						MERCURY_ENTITY_MESSAGE_FORWARD_CLIENT_APPEND((*pSendBundle), (*pForwardBundle));
-					}
+					// ȷУ ֮ȼ
+					if(updateQueue_.size() == 0 || (*iter)->priority() < minPriority)
+						minPriority = (*iter)->priority();
 
-					Mercury::Bundle::ObjPool().reclaimObject(pForwardBundle);
+					updateQueue_.push_back((*iter));
 				}
 
 				++iter;
 			}
 			
-			int32 packetsLength = pSendBundle->packetsLength();
-			if(packetsLength > 8/*MERCURY_ENTITY_MESSAGE_FORWARD_CLIENT_STARTĻС*/)
+			if(iter != aoiEntities_.end())
+				updateQueue_.clear();
+
+			// ȼֵԽСԽȸ£ ʵÿαºȼֵվ鼶ӣ
+			// ʱʵõĸ£ ԶʵƵƽĽͶᱻ
+			if(updateQueue_.size() > 0)
 			{
-				if(packetsLength > PACKET_MAX_SIZE_TCP)
+				uint32 count = updateQueue_.size();
+
+				updateHeap_.resize(count);
+				updatePosX_.resize(count);
+				updatePosY_.resize(count);
+				updatePosZ_.resize(count);
+				packedXZ_.resize(count * 3);
+				packedY_.resize(count * 2);
+
+				for(uint32 i=0; i<count; ++i)
 				{
-					WARNING_MSG(boost::format("Witness::update(%1%): sendToClient %2% Bytes.\n") % 
-						pEntity_->getID() % packetsLength);
+					EntityRef* pEntityRef = updateQueue_[i];
+					pEntityRef->priority(pEntityRef->priority() - minPriority);
+
+					const Position3D& pos = pEntityRef->pEntity()->getPosition();
+					updatePosX_[i] = pos.x;
+					updatePosY_[i] = pos.y;
+					updatePosZ_[i] = pos.z;
+
+					updateHeap_[i] = i;
 				}
 
-				pChannel->bundles().push_back(pSendBundle);
-			}
-			else
-			{
-				Mercury::Bundle::ObjPool().reclaimObject(pSendBundle);
+				// һentityԼλñ
+				const Position3D& basePos = pEntity_->getPosition();
+				MemoryStream::packRelativePositions(&updatePosX_[0], &updatePosY_[0], &updatePosZ_[0], count, 
+					basePos.x, basePos.y, basePos.z, &packedXZ_[0], &packedY_[0]);
+
+				entityref_index_priority_greater priorityGreater(updateQueue_);
+				std::make_heap(updateHeap_.begin(), updateHeap_.end(), priorityGreater);
+
+				while(updateHeap_.size() > 0 && remainPacketSize > 0)
+				{
+					std::pop_heap(updateHeap_.begin(), updateHeap_.end(), priorityGreater);
+					uint32 idx = updateHeap_.back();
+					updateHeap_.pop_back();
+
+					EntityRef* pEntityRef = updateQueue_[idx];
+					Entity* otherEntity = pEntityRef->pEntity();
+
+					// ֱд뷢Ͱ ﲻκζز
+					updateStream_.clear(false);
+					_addAOIEntityIDToStream(&updateStream_, pEntityRef);
+
+					const Mercury::MessageHandler* pMsgHandler = 
+						getUpdateMessageHandler(addEntityVolatileDataToStream(&updateStream_, otherEntity, 
+						&packedXZ_[idx * 3], &packedY_[idx * 2]));
+					
+					if(pMsgHandler)
+					{
+						remainPacketSize -= _addMessageToBundle(pVolatileBundle, *pMsgHandler, updateStream_);
+						pEntityRef->priority(pEntityRef->priority() + calcUpdatePriorityDelta(otherEntity));
+					}
+				}
+
+				updateQueue_.clear();
+				updateHeap_.clear();
 			}
+
+			// ɿĲǰ ͻյױʱӦʵѾAOI
+			// ɿUDPϼʹAOIϢʧش ױҲ֮Ŵ
+			_pushSendBundle(pChannel, pSendBundle);
+			_pushSendBundle(pChannel, pVolatileBundle);
 		}
 	}
 
@@ -716,6 +789,63 @@ bool Witness::update()
 	return true;
 }
 
+//-------------------------------------------------------------------------------------
+void Witness::_pushSendBundle(Mercury::Channel* pChannel, Mercury::Bundle* pSendBundle)
+{
+	int32 packetsLength = pSendBundle->packetsLength();
+	if(packetsLength > 8/*MERCURY_ENTITY_MESSAGE_FORWARD_CLIENT_STARTĻС*/)
+	{
+		if(packetsLength > PACKET_MAX_SIZE_TCP)
+		{
+			WARNING_MSG(boost::format("Witness::update(%1%): sendToClient %2% Bytes.\n") % 
+				pEntity_->getID() % packetsLength);
+		}
+
+		pChannel->bundles().push_back(pSendBundle);
+	}
+	else
+	{
+		Mercury::Bundle::ObjPool().reclaimObject(pSendBundle);
+	}
+}
+
+//-------------------------------------------------------------------------------------
+int32 Witness::_addMessageToBundle(Mercury::Bundle* pBundle, const Mercury::MessageHandler& msgHandler, 
+	const MemoryStream& s)
+{
+	KBE_ASSERT(msgHandler.msgLen == MERCURY_VARIABLE_MESSAGE);
+
+	Mercury::MessageLength msglen = s.opsize();
+	(*pBundle) << msgHandler.msgID;
+	(*pBundle) << msglen;
+	pBundle->append(s.data() + s.rpos(), s.opsize());
+
+	int32 length = MERCURY_MESSAGE_ID_SIZE + MERCURY_MESSAGE_LENGTH_SIZE + msglen;
+	Mercury::MercuryStats::getSingleton().trackMessage(Mercury::MercuryStats::SEND, msgHandler, length);
+	return length;
+}
+
+//-------------------------------------------------------------------------------------
+float Witness::calcUpdatePriorityDelta(Entity* otherEntity)
+{
+	Position3D distvec = otherEntity->getPosition() - pEntity_->getPosition();
+	float dist = KBEVec3Length(&distvec);
+
+	// ԽԶ鼶¼Խ
+	const DetailLevel& detailLevel = otherEntity->getScriptModule()->getDetailLevel();
+	float scale = 1.f;
+
+	for(int i=DETAIL_LEVEL_NEAR; i<=DETAIL_LEVEL_FAR; i++)
+	{
+		if(dist <= detailLevel.level[i].radius)
+			break;
+
+		scale += 1.f;
+	}
+
+	return (dist + WITNESS_UPDATE_PRIORITY_DISTANCE_BIAS) * scale;
+}
+
 //-------------------------------------------------------------------------------------
 void Witness::addBasePosToStream(Mercury::Bundle* pSendBundle)
 {
@@ -729,186 +859,168 @@ void Witness::addBasePosToStream(Mercury::Bundle* pSendBundle)
 	if(KBEVec3Length(&movement) < 0.0004f)
 		return;
 
-	Mercury::Bundle* pForwardBundle = Mercury::Bundle::ObjPool().createObject();
-	MemoryStream* s1 = MemoryStream::ObjPool().createObject();
+	updateStream_.clear(false);
 
 	if(fabs(lastBasePos.y - bpos.y) > 0.0004f)
 	{
-		(*pForwardBundle).newMessage(ClientInterface::onUpdateBasePos);
-		s1->appendPackAnyXYZ(bpos.x, bpos.y, bpos.z, 0.f);
+		updateStream_.appendPackAnyXYZ(bpos.x, bpos.y, bpos.z, 0.f);
+		_addMessageToBundle(pSendBundle, ClientInterface::onUpdateBasePos, updateStream_);
 	}
 	else
 	{
-		(*pForwardBundle).newMessage(ClientInterface::onUpdateBasePosXZ);
-		s1->appendPackAnyXZ(bpos.x, bpos.z, 0.f);
+		updateStream_.appendPackAnyXZ(bpos.x, bpos.z, 0.f);
+		_addMessageToBundle(pSendBundle, ClientInterface::onUpdateBasePosXZ, updateStream_);
 	}
 
-	(*pForwardBundle).append(*s1);
-	MERCURY_ENTITY_MESSAGE_FORWARD_CLIENT_APPEND((*pSendBundle), (*pForwardBundle));
-	Mercury::Bundle::ObjPool().reclaimObject(pForwardBundle);
-	MemoryStream::ObjPool().reclaimObject(s1);
-
 	lastBasePos = bpos;
 }
 
 //-------------------------------------------------------------------------------------
-void Witness::addUpdateHeadToStream(Mercury::Bundle* pForwardBundle, uint32 flags, EntityRef* pEntityRef)
+const Mercury::MessageHandler* Witness::getUpdateMessageHandler(uint32 flags)
 {
+	const Mercury::MessageHandler* pMsgHandler = NULL;
+
 	switch(flags)
 	{
 	case UPDATE_FLAG_NULL:
 		{
-			// (*pForwardBundle).newMessage(ClientInterface::onUpdateData);
+			// pMsgHandler = &ClientInterface::onUpdateData;
 		}
 		break;
 	case UPDATE_FLAG_XZ:
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xz);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xz;
 		}
 		break;
 	case UPDATE_FLAG_XYZ:
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xyz);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xyz;
 		}
 		break;
 	case UPDATE_FLAG_YAW:
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_y);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_y;
 		}
 		break;
 	case UPDATE_FLAG_ROLL:
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_r);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_r;
 		}
 		break;
 	case UPDATE_FLAG_PITCH:
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_p);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_p;
 		}
 		break;
 	case UPDATE_FLAG_YAW_PITCH_ROLL:
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_ypr);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_ypr;
 		}
 		break;
 	case UPDATE_FLAG_YAW_PITCH:
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_yp);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_yp;
 		}
 		break;
 	case UPDATE_FLAG_YAW_ROLL:
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_yr);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_yr;
 		}
 		break;
 	case UPDATE_FLAG_PITCH_ROLL:
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_pr);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_pr;
 		}
 		break;
 	case (UPDATE_FLAG_XZ | UPDATE_FLAG_YAW):
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xz_y);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xz_y;
 		}
 		break;
 	case (UPDATE_FLAG_XZ | UPDATE_FLAG_PITCH):
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xz_p);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xz_p;
 		}
 		break;
 	case (UPDATE_FLAG_XZ | UPDATE_FLAG_ROLL):
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xz_r);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xz_r;
 		}
 		break;
 	case (UPDATE_FLAG_XZ | UPDATE_FLAG_YAW_ROLL):
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xz_yr);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xz_yr;
 		}
 		break;
 	case (UPDATE_FLAG_XZ | UPDATE_FLAG_YAW_PITCH):
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xz_yp);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xz_yp;
 		}
 		break;
 	case (UPDATE_FLAG_XZ | UPDATE_FLAG_PITCH_ROLL):
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xz_pr);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xz_pr;
 		}
 		break;
 	case (UPDATE_FLAG_XZ | UPDATE_FLAG_YAW_PITCH_ROLL):
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xz_ypr);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xz_ypr;
 		}
 		break;
 	case (UPDATE_FLAG_XYZ | UPDATE_FLAG_YAW):
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xyz_y);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xyz_y;
 		}
 		break;
 	case (UPDATE_FLAG_XYZ | UPDATE_FLAG_PITCH):
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xyz_p);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xyz_p;
 		}
 		break;
 	case (UPDATE_FLAG_XYZ | UPDATE_FLAG_ROLL):
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xyz_r);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xyz_r;
 		}
 		break;
 	case (UPDATE_FLAG_XYZ | UPDATE_FLAG_YAW_ROLL):
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xyz_yr);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xyz_yr;
 		}
 		break;
 	case (UPDATE_FLAG_XYZ | UPDATE_FLAG_YAW_PITCH):
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xyz_yp);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xyz_yp;
 		}
 		break;
 	case (UPDATE_FLAG_XYZ | UPDATE_FLAG_PITCH_ROLL):
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xyz_pr);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xyz_pr;
 		}
 		break;
 	case (UPDATE_FLAG_XYZ | UPDATE_FLAG_YAW_PITCH_ROLL):
 		{
-			(*pForwardBundle).newMessage(ClientInterface::onUpdateData_xyz_ypr);
-			_addAOIEntityIDToBundle(pForwardBundle, pEntityRef);
+			pMsgHandler = &ClientInterface::onUpdateData_xyz_ypr;
 		}
 		break;
 	default:
 		KBE_ASSERT(false);
 		break;
 	};
+
+	return pMsgHandler;
 }
 
 //-------------------------------------------------------------------------------------
-uint32 Witness::addEntityVolatileDataToStream(MemoryStream* mstream, Entity* otherEntity)
+const VolatileDataCache& Witness::getVolatileDataCache(Entity* otherEntity)
 {
-	uint32 flags = UPDATE_FLAG_NULL;
+	VolatileDataCache& cache = otherEntity->volatileDataCache();
+	if(cache.time == g_kbetime)
+		return cache;
+
+	cache.time = g_kbetime;
+	cache.updatePosition = false;
+	cache.dirFlags = UPDATE_FLAG_NULL;
+	cache.dirSize = 0;
 
 	const VolatileInfo& volatileInfo = otherEntity->getScriptModule()->getVolatileInfo();
 	
@@ -916,18 +1028,7 @@ uint32 Witness::addEntityVolatileDataToStream(MemoryStream* mstream, Entity* oth
 	
 	if((volatileInfo.position() > 0.f) && (entity_posdir_additional_updates == 0 || g_kbetime - otherEntity->posChangedTime() < entity_posdir_additional_updates))
 	{
-		Position3D relativePos = otherEntity->getPosition() - this->pEntity()->getPosition();
-		mstream->appendPackXZ(relativePos.x, relativePos.z);
-
-		if(!otherEntity->isOnGround())
-		{
-			mstream->appendPackY(relativePos.y);
-			flags |= UPDATE_FLAG_XYZ; 
-		}
-		else
-		{
-			flags |= UPDATE_FLAG_XZ; 
-		}
+		cache.updatePosition = true;
 	}
 
 	if((entity_posdir_additional_updates == 0) || (g_kbetime - otherEntity->dirChangedTime() < entity_posdir_additional_updates))
@@ -935,53 +1036,93 @@ uint32 Witness::addEntityVolatileDataToStream(MemoryStream* mstream, Entity* oth
 		const Direction3D& dir = otherEntity->getDirection();
 		if(volatileInfo.yaw() > 0.f && volatileInfo.roll() > 0.f && volatileInfo.pitch() > 0.f)
 		{
-			(*mstream) << angle2int8(dir.yaw());
-			(*mstream) << angle2int8(dir.pitch());
-			(*mstream) << angle2int8(dir.roll());
+			cache.dirData[cache.dirSize++] = angle2int8(dir.yaw());
+			cache.dirData[cache.dirSize++] = angle2int8(dir.pitch());
+			cache.dirData[cache.dirSize++] = angle2int8(dir.roll());
 
-			flags |= UPDATE_FLAG_YAW_PITCH_ROLL; 
+			cache.dirFlags |= UPDATE_FLAG_YAW_PITCH_ROLL; 
 		}
 		else if(volatileInfo.roll() > 0.f && volatileInfo.pitch() > 0.f)
 		{
-			(*mstream) << angle2int8(dir.pitch());
-			(*mstream) << angle2int8(dir.roll());
+			cache.dirData[cache.dirSize++] = angle2int8(dir.pitch());
+			cache.dirData[cache.dirSize++] = angle2int8(dir.roll());
 
-			flags |= UPDATE_FLAG_PITCH_ROLL; 
+			cache.dirFlags |= UPDATE_FLAG_PITCH_ROLL; 
 		}
 		else if(volatileInfo.yaw() > 0.f && volatileInfo.pitch() > 0.f)
 		{
-			(*mstream) << angle2int8(dir.yaw());
-			(*mstream) << angle2int8(dir.pitch());
+			cache.dirData[cache.dirSize++] = angle2int8(dir.yaw());
+			cache.dirData[cache.dirSize++] = angle2int8(dir.pitch());
 
-			flags |= UPDATE_FLAG_YAW_PITCH; 
+			cache.dirFlags |= UPDATE_FLAG_YAW_PITCH; 
 		}
 		else if(volatileInfo.yaw() > 0.f && volatileInfo.roll() > 0.f)
 		{
-			(*mstream) << angle2int8(dir.yaw());
-			(*mstream) << angle2int8(dir.roll());
+			cache.dirData[cache.dirSize++] = angle2int8(dir.yaw());
+			cache.dirData[cache.dirSize++] = angle2int8(dir.roll());
 
-			flags |= UPDATE_FLAG_YAW_ROLL; 
+			cache.dirFlags |= UPDATE_FLAG_YAW_ROLL; 
 		}
 		else if(volatileInfo.yaw() > 0.f)
 		{
-			(*mstream) << angle2int8(dir.yaw());
+			cache.dirData[cache.dirSize++] = angle2int8(dir.yaw());
 
-			flags |= UPDATE_FLAG_YAW; 
+			cache.dirFlags |= UPDATE_FLAG_YAW; 
 		}
 		else if(volatileInfo.roll() > 0.f)
 		{
-			(*mstream) << angle2int8(dir.roll());
+			cache.dirData[cache.dirSize++] = angle2int8(dir.roll());
 
-			flags |= UPDATE_FLAG_ROLL; 
+			cache.dirFlags |= UPDATE_FLAG_ROLL; 
 		}
 		else if(volatileInfo.pitch() > 0.f)
 		{
-			(*mstream) << angle2int8(dir.pitch());
+			cache.dirData[cache.dirSize++] = angle2int8(dir.pitch());
 
-			flags |= UPDATE_FLAG_PITCH; 
+			cache.dirFlags |= UPDATE_FLAG_PITCH; 
 		}
 	}
 
+	return cache;
+}
+
+//-------------------------------------------------------------------------------------
+uint32 Witness::addEntityVolatileDataToStream(MemoryStream* mstream, Entity* otherEntity, 
+	const uint8* packedXZ, const uint8* packedY)
+{
+	// ±־й۲߶ͬ ÿtickֻһΣ ֻҪλ
+	const VolatileDataCache& cache = getVolatileDataCache(otherEntity);
+	uint32 flags = cache.dirFlags;
+
+	if(cache.updatePosition)
+	{
+		Position3D relativePos;
+		if(packedXZ == NULL || packedY == NULL)
+			relativePos = otherEntity->getPosition() - this->pEntity()->getPosition();
+
+		if(packedXZ)
+			mstream->append(packedXZ, 3);
+		else
+			mstream->appendPackXZ(relativePos.x, relativePos.z);
+
+		if(!otherEntity->isOnGround())
+		{
+			if(packedY)
+				mstream->append(packedY, 2);
+			else
+				mstream->appendPackY(relativePos.y);
+
+			flags |= UPDATE_FLAG_XYZ; 
+		}
+		else
+		{
+			flags |= UPDATE_FLAG_XZ; 
+		}
+	}
+
+	if(cache.dirSize > 0)
+		mstream->append(cache.dirData, cache.dirSize);
+
 	return flags;
 }
 
@@ -1001,5 +1142,45 @@ bool Witness::sendToClient(const Mercury::MessageHandler& msgHandler, Mercury::B
 	return false;
 }
 
+//-------------------------------------------------------------------------------------
+int32 Witness::sendEntityMessageToClient(const Mercury::MessageHandler& normalMsgHandler, 
+	const Mercury::MessageHandler& optimizedMsgHandler, ENTITY_ID entityID, const MemoryStream& s)
+{
+	Bundles* lpBundles = pBundles();
+
+	if(lpBundles == NULL)
+	{
+		ERROR_MSG(boost::format("Witness::sendEntityMessageToClient: %1% pBundles is NULL, not found channel.\n") % pEntity_->getID());
+		return 0;
+	}
+
+	uint8 aliasID = 0;
+	bool useAliasID = EntityDef::entityAliasID() && aoiEntities_.size() <= 255 && 
+		entityID2AliasID(entityID, aliasID);
+
+	const Mercury::MessageHandler& msgHandler = useAliasID ? optimizedMsgHandler : normalMsgHandler;
+	KBE_ASSERT(msgHandler.msgLen == MERCURY_VARIABLE_MESSAGE);
+
+	Mercury::MessageLength msglen = (useAliasID ? sizeof(uint8) : sizeof(ENTITY_ID)) + s.opsize();
+
+	// ͻϢֱдתϢ֮ ҪΪÿwitnessٴһת
+	Mercury::Bundle* pSendBundle = Mercury::Bundle::ObjPool().createObject();
+	MERCURY_ENTITY_MESSAGE_FORWARD_CLIENT_START(pEntity_->getID(), (*pSendBundle));
+
+	(*pSendBundle) << msgHandler.msgID;
+	(*pSendBundle) << msglen;
+
+	if(useAliasID)
+		(*pSendBundle) << aliasID;
+	else
+		(*pSendBundle) << entityID;
+
+	pSendBundle->append(s.data() + s.rpos(), s.opsize());
+	lpBundles->push_back(pSendBundle);
+
+	Mercury::MercuryStats::getSingleton().trackMessage(Mercury::MercuryStats::SEND, msgHandler, msglen);
+	return MERCURY_MESSAGE_ID_SIZE + MERCURY_MESSAGE_LENGTH_SIZE + msglen;
+}
+
 //-------------------------------------------------------------------------------------
 }
@@ -27,9 +27,14 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "helper/debug_helper.hpp"
 #include "cstdkbe/cstdkbe.hpp"
 #include "cstdkbe/objectpool.hpp"
+#include "cstdkbe/memorystream.hpp"
 #include "math/math.hpp"
 
 // #define NDEBUG
+
+// witnessȼʵʱ ϸӵƫƣ ʹ÷ǳʵ֮ȼ಻ڹ
+#define WITNESS_UPDATE_PRIORITY_DISTANCE_BIAS	5.f
+
 // windows include	
 #if KBE_PLATFORM == PLATFORM_WIN32	
 #else
@@ -45,6 +50,7 @@ namespace Mercury
 }
 
 class Entity;
+struct VolatileDataCache;
 class MemoryStream;
 class AOITrigger;
 class Space;
@@ -98,7 +104,8 @@ public:
 		size_t bytes = sizeof(pEntity_)
 		 + sizeof(aoiRadius_) + sizeof(aoiHysteresisArea_)
 		  + sizeof(pAOITrigger_) + sizeof(clientAOISize_)
-		  + sizeof(lastBasePos) + (sizeof(EntityRef*) * aoiEntities_.size());
+		  + sizeof(lastBasePos) + (sizeof(EntityRef*) * aoiEntities_.size())
+		  + ((sizeof(ENTITY_ID) + sizeof(EntityRef*)) * aoiEntitiesMap_.size());
 
 		return bytes;
 	}
@@ -134,7 +141,13 @@ public:
 	/**
 		дVolatileݵ
 	*/
-	uint32 addEntityVolatileDataToStream(MemoryStream* mstream, Entity* otherEntity);
+	uint32 addEntityVolatileDataToStream(MemoryStream* mstream, Entity* otherEntity, 
+		const uint8* packedXZ = NULL, const uint8* packedY = NULL);
+
+	/**
+		entitytickvolatileݻ棬 tickδȼ
+	*/
+	const VolatileDataCache& getVolatileDataCache(Entity* otherEntity);
 	
 
 	void addSmartAOIEntityMessageToBundle(Mercury::Bundle* pBundle, const Mercury::MessageHandler& normalMsgHandler, 
@@ -143,9 +156,14 @@ public:
 	bool entityID2AliasID(ENTITY_ID id, uint8& aliasID)const;
 
 	/**
-		ʹúЭ¿ͻ
+		ʹúЭ¿ͻˣ ûҪµ򷵻NULL
+	*/
+	const Mercury::MessageHandler* getUpdateMessageHandler(uint32 flags);
+
+	/**
+		ʵÿαºȼֵӵ 鼶
 	*/
-	void addUpdateHeadToStream(Mercury::Bundle* pForwardBundle, uint32 flags, EntityRef* pEntityRef);
+	float calcUpdatePriorityDelta(Entity* otherEntity);
 
 	/**
 		ӻλõ°
@@ -157,6 +175,13 @@ public:
 	*/
 	bool sendToClient(const Mercury::MessageHandler& msgHandler, Mercury::Bundle* pBundle);
 
+	/**
+		witnessͻһĳentityϢ ϢsѾԤлòҿɱwitnessã
+		ֻдתͷͿͻϢͷ(entityID߱ID) ؿͻϢĳȣ ʧܷ0
+	*/
+	int32 sendEntityMessageToClient(const Mercury::MessageHandler& normalMsgHandler, 
+		const Mercury::MessageHandler& optimizedMsgHandler, ENTITY_ID entityID, const MemoryStream& s);
+
 	INLINE EntityRef::AOI_ENTITIES& aoiEntities();
 
 	/** aoientity */
@@ -173,6 +198,24 @@ private:
 	INLINE void _addAOIEntityIDToStream(MemoryStream* mstream, EntityRef* entityRef);
 	INLINE void _addAOIEntityIDToBundle(Mercury::Bundle* pBundle, EntityRef* entityRef);
 	INLINE void _addAOIEntityIDToBundle(Mercury::Bundle* pBundle, ENTITY_ID entityID);
+
+	/**
+		ӺɾaoiEntities_еentityRef ͬʱάaoiEntitiesMap_entityRefıID
+	*/
+	void _addAOIEntityRef(EntityRef* pEntityRef);
+	EntityRef::AOI_ENTITIES::iterator _delAOIEntityRef(EntityRef::AOI_ENTITIES::iterator iter);
+	void _clearAOIEntityRefs();
+
+	/**
+		һͻϢ(ϢΪs)ֱ׷ӵתУ дĳ
+	*/
+	int32 _addMessageToBundle(Mercury::Bundle* pBundle, const Mercury::MessageHandler& msgHandler, 
+		const MemoryStream& s);
+
+	/**
+		תгתͷ֮⻹ͨķͶУ 
+	*/
+	void _pushSendBundle(Mercury::Channel* pChannel, Mercury::Bundle* pSendBundle);
 private:
 	Entity*									pEntity_;
 
@@ -182,11 +225,26 @@ private:
 	AOITrigger*								pAOITrigger_;
 
 	EntityRef::AOI_ENTITIES					aoiEntities_;
+	EntityRef::AOI_ENTITIES_MAP				aoiEntitiesMap_;					// entityIDaoiEntities_, ٲ
 
 	Position3D								lastBasePos;
 
 	uint16									clientAOISize_;
 
+	// ÿҪȼµentity ΪԱÿ֡·
+	EntityRef::AOI_ENTITIES					updateQueue_;
+	std::vector<uint32>						updateHeap_;						// updateQueue_ ȼɶ
+
+	// updateQueue_entity(ṹ)Լλñ
+	std::vector<float>						updatePosX_;
+	std::vector<float>						updatePosY_;
+	std::vector<float>						updatePosZ_;
+	std::vector<uint8>						packedXZ_;
+	std::vector<uint8>						packedY_;
+
+	// ¿ͻʱʹõʱ ÿʹǰգ ÿ֡Ӷз
+	MemoryStream							updateStream_;
+
 };
 
 }
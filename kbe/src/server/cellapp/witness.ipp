@@ -42,12 +42,11 @@ INLINE float Witness::aoiHysteresisArea()const
 //-------------------------------------------------------------------------------------
 INLINE EntityRef* Witness::getAOIEntityRef(ENTITY_ID entityID)
 {
-	EntityRef::AOI_ENTITIES::iterator iter = std::find_if(aoiEntities_.begin(), aoiEntities_.end(), 
-		findif_vector_entityref_exist_by_entityid_handler(entityID));
+	EntityRef::AOI_ENTITIES_MAP::iterator iter = aoiEntitiesMap_.find(entityID);
 
-	if(iter != aoiEntities_.end())
+	if(iter != aoiEntitiesMap_.end())
 	{
-		return (*iter);
+		return iter->second;
 	}
 	
 	return NULL;
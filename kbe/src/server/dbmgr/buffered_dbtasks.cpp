@@ -30,6 +30,9 @@ namespace KBEngine{
 Buffered_DBTasks::Buffered_DBTasks():
 dbid_tasks_(),
 entityid_tasks_(),
+batchTasks_(),
+batchStartTime_(0),
+numCoalescedWrites_(0),
 mutex_()
 {
 }
@@ -68,7 +71,7 @@ bool Buffered_DBTasks::hasTask_(ENTITY_ID entityID)
 }
 
 //-------------------------------------------------------------------------------------
-void Buffered_DBTasks::addTask(EntityDBTask* pTask)
+bool Buffered_DBTasks::addTask_(EntityDBTask* pTask)
 {
 	mutex_.lockMutex();
 	pTask->pBuffered_DBTasks(this);
@@ -79,7 +82,7 @@ void Buffered_DBTasks::addTask(EntityDBTask* pTask)
 		{
 			entityid_tasks_.insert(std::make_pair(pTask->EntityDBTask_entityID(), pTask));
 			mutex_.unlockMutex();
-			return;
+			return false;
 		}
 
 		entityid_tasks_.insert(std::make_pair(pTask->EntityDBTask_entityID(), 
@@ -91,7 +94,7 @@ void Buffered_DBTasks::addTask(EntityDBTask* pTask)
 		{
 			dbid_tasks_.insert(std::make_pair(pTask->EntityDBTask_entityDBID(), pTask));
 			mutex_.unlockMutex();
-			return;
+			return false;
 		}
 
 		dbid_tasks_.insert(std::make_pair(pTask->EntityDBTask_entityDBID(), 
@@ -99,7 +102,93 @@ void Buffered_DBTasks::addTask(EntityDBTask* pTask)
 	}
 
 	mutex_.unlockMutex();
-	DBUtil::pThreadPool()->addTask(pTask);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------
+bool Buffered_DBTasks::coalesceTask_(DBTaskWriteEntity* pTask)
+{
+	if(!g_kbeSrvConfig.getDBMgr().db_coalesceWrites || pTask->EntityDBTask_entityDBID() <= 0)
+		return false;
+
+	bool ret = false;
+	mutex_.lockMutex();
+
+	std::pair<DBID_TASKS_MAP::iterator, DBID_TASKS_MAP::iterator> range = 
+		dbid_tasks_.equal_range(pTask->EntityDBTask_entityDBID());  
+
+	// һִе ֻܺϲһδʼУ ֤Ⱥ˳
+	if(range.first != range.second)
+	{
+		DBID_TASKS_MAP::iterator lastIter = range.second;
+		--lastIter;
+
+		if(lastIter != range.first && lastIter->second != NULL)
+			ret = lastIter->second->mergeWriteTask(pTask);
+	}
+
+	mutex_.unlockMutex();
+
+	if(ret)
+	{
+		++numCoalescedWrites_;
+		delete pTask;
+	}
+
+	return ret;
+}
+
+//-------------------------------------------------------------------------------------
+void Buffered_DBTasks::addTask(EntityDBTask* pTask)
+{
+	if(addTask_(pTask))
+		DBUtil::pThreadPool()->addTask(pTask);
+}
+
+//-------------------------------------------------------------------------------------
+void Buffered_DBTasks::addTask(DBTaskWriteEntity* pTask)
+{
+	if(coalesceTask_(pTask))
+		return;
+
+	uint32 maxEntities = g_kbeSrvConfig.getDBMgr().db_batchWriteMaxEntities;
+
+	// entityҪȵõdbidдlog д
+	if(maxEntities <= 1 || pTask->EntityDBTask_entityDBID() <= 0)
+	{
+		addTask(static_cast<EntityDBTask*>(pTask));
+		return;
+	}
+
+	// ͬһdbidǰ滹δ˳Ŷӣ ֵʱݿֱִ߳
+	if(!addTask_(pTask))
+		return;
+
+	if(batchTasks_.size() == 0)
+		batchStartTime_ = timestamp();
+
+	batchTasks_.push_back(pTask);
+
+	if(batchTasks_.size() >= maxEntities)
+		flushBatch(true);
+}
+
+//-------------------------------------------------------------------------------------
+void Buffered_DBTasks::flushBatch(bool force)
+{
+	if(batchTasks_.size() == 0)
+		return;
+
+	if(!force && (timestamp() - batchStartTime_) < 
+		(g_kbeSrvConfig.getDBMgr().db_batchWriteMaxLatency * stampsPerSecond() / 1000))
+		return;
+
+	if(batchTasks_.size() == 1)
+		DBUtil::pThreadPool()->addTask(batchTasks_[0]);
+	else
+		DBUtil::pThreadPool()->addTask(new DBTaskWriteEntityBatch(batchTasks_));
+
+	batchTasks_.clear();
 }
 
 //-------------------------------------------------------------------------------------
@@ -46,6 +46,17 @@ public:
 	
 	void addTask(EntityDBTask* pTask);
 
+	/**
+		ѴݿеentityдȻ ﵽʱ޺ݿ߳
+	*/
+	void addTask(DBTaskWriteEntity* pTask);
+	void flushBatch(bool force = false);
+
+	/**
+		ṩwatcherʹ
+	*/
+	uint32 numCoalescedWrites()const{ return numCoalescedWrites_; }
+
 	EntityDBTask* tryGetNextTask(EntityDBTask* pTask);
 
 	size_t size(){ return dbid_tasks_.size() + entityid_tasks_.size(); }
@@ -83,9 +94,18 @@ protected:
 	bool hasTask_(DBID dbid);
 	bool hasTask_(ENTITY_ID entityID);
 
+	bool addTask_(EntityDBTask* pTask);
+	bool coalesceTask_(DBTaskWriteEntity* pTask);
+
 	DBID_TASKS_MAP dbid_tasks_;
 	ENTITYID_TASKS_MAP entityid_tasks_;
 
+	// ȴд ̷ֻ߳
+	std::vector<DBTaskWriteEntity*> batchTasks_;
+	uint64 batchStartTime_;
+
+	uint32 numCoalescedWrites_;
+
 	KBEngine::thread::ThreadMutex mutex_;
 };
 
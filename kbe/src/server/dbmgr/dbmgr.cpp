@@ -109,6 +109,7 @@ bool Dbmgr::initializeWatcher()
 	WATCH_OBJECT("DBThreadPool/entityid_tasksSize", &bufferedDBTasks_, &Buffered_DBTasks::entityid_tasksSize);
 	WATCH_OBJECT("DBThreadPool/printBuffered_dbid", &bufferedDBTasks_, &Buffered_DBTasks::printBuffered_dbid);
 	WATCH_OBJECT("DBThreadPool/printBuffered_entityID", &bufferedDBTasks_, &Buffered_DBTasks::printBuffered_entityID);
+	WATCH_OBJECT("DBThreadPool/numCoalescedWrites", &bufferedDBTasks_, &Buffered_DBTasks::numCoalescedWrites);
 
 	return ServerApp::initializeWatcher() && DBUtil::pThreadPool()->initializeWatcher();
 }
@@ -144,6 +145,7 @@ void Dbmgr::handleMainTick()
 	 //DEBUG_MSG("Dbmgr::handleGameTick[%"PRTime"]:%u\n", t, time_);
 	
 	g_kbetime++;
+	bufferedDBTasks_.flushBatch();
 	threadPool_.onMainThreadTick();
 	DBUtil::pThreadPool()->onMainThreadTick();
 	getNetworkInterface().processAllChannelPackets(&DbmgrInterface::messageHandlers);
@@ -305,7 +305,8 @@ eid_(eid),
 entityDBID_(entityDBID),
 sid_(0),
 callbackID_(0),
-success_(false)
+success_(false),
+mergedCallbacks_()
 {
 }
 
@@ -314,6 +315,35 @@ DBTaskWriteEntity::~DBTaskWriteEntity()
 {
 }
 
+//-------------------------------------------------------------------------------------
+bool DBTaskWriteEntity::mergeWriteTask(DBTaskWriteEntity* pTask)
+{
+	// entityдlogϢ ϲ
+	if(entityDBID_ <= 0 || pTask->entityDBID_ != entityDBID_)
+		return false;
+
+	MemoryStream& s = *pTask->pDatas_;
+	if(s.read<ENTITY_SCRIPT_UID>(s.rpos()) != pDatas_->read<ENTITY_SCRIPT_UID>(pDatas_->rpos()))
+		return false;
+
+	ENTITY_SCRIPT_UID sid;
+	MERGED_CALLBACK callback;
+	callback.addr = pTask->addr_;
+	callback.eid = pTask->eid_;
+
+	s >> sid >> callback.callbackID;
+
+	// (uid, value)ʽ˳У ֱӽں棬 дʱͬһֵΪ׼
+	pDatas_->append(s.data() + s.rpos(), s.opsize());
+	s.opfini();
+
+	mergedCallbacks_.push_back(callback);
+	mergedCallbacks_.insert(mergedCallbacks_.end(), pTask->mergedCallbacks_.begin(), 
+		pTask->mergedCallbacks_.end());
+
+	return true;
+}
+
 //-------------------------------------------------------------------------------------
 bool DBTaskWriteEntity::db_thread_process()
 {
@@ -361,20 +391,138 @@ thread::TPTask::TPTaskState DBTaskWriteEntity::presentMainThread()
 	DEBUG_MSG(boost::format("Dbmgr::writeEntity: %1%(%2%).\n") % pModule->getName() % entityDBID_);
 
 	// дentityĽ ɹʧ
+	sendCallback(addr_, eid_, callbackID_);
 
+	std::vector<MERGED_CALLBACK>::iterator iter = mergedCallbacks_.begin();
+	for(; iter != mergedCallbacks_.end(); iter++)
+		sendCallback(iter->addr, iter->eid, iter->callbackID);
+
+	return EntityDBTask::presentMainThread();
+}
+
+//-------------------------------------------------------------------------------------
+void DBTaskWriteEntity::sendCallback(const Mercury::Address& addr, ENTITY_ID eid, CALLBACK_ID callbackID)
+{
 	Mercury::Bundle* pBundle = Mercury::Bundle::ObjPool().createObject();
 	(*pBundle).newMessage(BaseappInterface::onWriteToDBCallback);
 	BaseappInterface::onWriteToDBCallbackArgs4::staticAddToBundle((*pBundle), 
-		eid_, entityDBID_, callbackID_, success_);
+		eid, entityDBID_, callbackID, success_);
 
-	if(!this->send((*pBundle)))
+	Mercury::Channel* pChannel = Dbmgr::getSingleton().getNetworkInterface().findChannel(addr);
+	
+	if(pChannel)
+	{
+		(*pBundle).send(Dbmgr::getSingleton().getNetworkInterface(), pChannel);
+	}
+	else
 	{
-		ERROR_MSG(boost::format("DBTaskWriteEntity::presentMainThread: channel(%1%) not found.\n") % addr_.c_str());
+		ERROR_MSG(boost::format("DBTaskWriteEntity::presentMainThread: channel(%1%) not found.\n") % addr.c_str());
 	}
 
 	Mercury::Bundle::ObjPool().reclaimObject(pBundle);
-	
-	return EntityDBTask::presentMainThread();
+}
+
+//-------------------------------------------------------------------------------------
+DBTaskWriteEntityBatch::DBTaskWriteEntityBatch(std::vector<DBTaskWriteEntity*>& tasks):
+DBTaskBase(),
+tasks_(tasks)
+{
+}
+
+//-------------------------------------------------------------------------------------
+DBTaskWriteEntityBatch::~DBTaskWriteEntityBatch()
+{
+	std::vector<DBTaskWriteEntity*>::iterator iter = tasks_.begin();
+	for(; iter != tasks_.end(); iter++)
+		delete (*iter);
+}
+
+//-------------------------------------------------------------------------------------
+void DBTaskWriteEntityBatch::pdbi(DBInterface* ptr)
+{
+	DBTaskBase::pdbi(ptr);
+
+	std::vector<DBTaskWriteEntity*>::iterator iter = tasks_.begin();
+	for(; iter != tasks_.end(); iter++)
+		(*iter)->pdbi(ptr);
+}
+
+//-------------------------------------------------------------------------------------
+bool DBTaskWriteEntityBatch::db_thread_process()
+{
+	// entityͷ飬 ͬ͵entityдͬһ
+	std::map<ENTITY_SCRIPT_UID, std::vector<DBTaskWriteEntity*> > groups;
+
+	std::vector<DBTaskWriteEntity*>::iterator iter = tasks_.begin();
+	for(; iter != tasks_.end(); iter++)
+	{
+		DBTaskWriteEntity* pTask = (*iter);
+		(*pTask->pDatas_) >> pTask->sid_ >> pTask->callbackID_;
+		groups[pTask->sid_].push_back(pTask);
+	}
+
+	std::map<ENTITY_SCRIPT_UID, std::vector<DBTaskWriteEntity*> >::iterator groupIter = groups.begin();
+	for(; groupIter != groups.end(); groupIter++)
+	{
+		std::vector<DBTaskWriteEntity*>& tasks = groupIter->second;
+
+		std::vector<DBID> dbids;
+		std::vector<MemoryStream*> streams;
+		std::vector<bool> results;
+
+		for(iter = tasks.begin(); iter != tasks.end(); iter++)
+		{
+			KBE_ASSERT((*iter)->entityDBID_ > 0);
+			dbids.push_back((*iter)->entityDBID_);
+			streams.push_back((*iter)->pDatas_);
+		}
+
+		EntityTables::getSingleton().writeEntities(pdbi_, dbids, streams, results, 
+			EntityDef::findScriptModule(groupIter->first));
+
+		for(size_t i = 0; i < tasks.size(); i++)
+			tasks[i]->success_ = results[i];
+	}
+
+	return false;
+}
+
+//-------------------------------------------------------------------------------------
+DBTaskBase* DBTaskWriteEntityBatch::tryGetNextTask()
+{
+	// ÿentity񶼿Կʼִˣ һɵǰִ̼߳
+	DBTaskBase* pNextTask = NULL;
+
+	std::vector<DBTaskWriteEntity*>::iterator iter = tasks_.begin();
+	for(; iter != tasks_.end(); iter++)
+	{
+		DBTask* pTask = (*iter)->tryGetNextTask();
+		if(pTask == NULL)
+			continue;
+
+		if(pNextTask == NULL)
+			pNextTask = pTask;
+		else
+			DBUtil::pThreadPool()->addTask(pTask);
+	}
+
+	return pNextTask;
+}
+
+//-------------------------------------------------------------------------------------
+thread::TPTask::TPTaskState DBTaskWriteEntityBatch::presentMainThread()
+{
+	DEBUG_MSG(boost::format("Dbmgr::writeEntityBatch: size=%1%.\n") % tasks_.size());
+
+	std::vector<DBTaskWriteEntity*>::iterator iter = tasks_.begin();
+	for(; iter != tasks_.end(); iter++)
+	{
+		(*iter)->presentMainThread();
+		delete (*iter);
+	}
+
+	tasks_.clear();
+	return DBTaskBase::presentMainThread();
 }
 
 //-------------------------------------------------------------------------------------
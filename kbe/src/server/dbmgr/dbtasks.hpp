@@ -36,6 +36,7 @@ namespace KBEngine{
 
 class DBInterface;
 class Buffered_DBTasks;
+class DBTaskWriteEntity;
 struct ACCOUNT_INFOS;
 
 /*
@@ -90,6 +91,11 @@ public:
 	DBID EntityDBTask_entityDBID()const { return _entityDBID; }
 	
 	void pBuffered_DBTasks(Buffered_DBTasks* v){ _pBuffered_DBTasks = v; }
+
+	/**
+		һںдϲУ ֺ֧ϲ򷵻false
+	*/
+	virtual bool mergeWriteTask(DBTaskWriteEntity* pTask){ return false; }
 	virtual thread::TPTask::TPTaskState presentMainThread();
 
 	DBTask* tryGetNextTask();
@@ -143,6 +149,7 @@ protected:
 */
 class DBTaskWriteEntity : public EntityDBTask
 {
+	friend class DBTaskWriteEntityBatch;
 public:
 	DBTaskWriteEntity(const Mercury::Address& addr, COMPONENT_ID componentID, 
 		ENTITY_ID eid, DBID entityDBID, MemoryStream& datas);
@@ -150,13 +157,45 @@ public:
 	virtual ~DBTaskWriteEntity();
 	virtual bool db_thread_process();
 	virtual thread::TPTask::TPTaskState presentMainThread();
+
+	virtual bool mergeWriteTask(DBTaskWriteEntity* pTask);
 protected:
+	void sendCallback(const Mercury::Address& addr, ENTITY_ID eid, CALLBACK_ID callbackID);
+
 	COMPONENT_ID componentID_;
 	ENTITY_ID eid_;
 	DBID entityDBID_;
 	ENTITY_SCRIPT_UID sid_;
 	CALLBACK_ID callbackID_;
 	bool success_;
+
+	// ϲдߣ дɺҲҪص
+	struct MERGED_CALLBACK
+	{
+		Mercury::Address addr;
+		ENTITY_ID eid;
+		CALLBACK_ID callbackID;
+	};
+
+	std::vector<MERGED_CALLBACK> mergedCallbacks_;
+};
+
+/**
+	ݿдentity ͬһύ ÿentityĽصbaseapp
+*/
+class DBTaskWriteEntityBatch : public DBTaskBase
+{
+public:
+	DBTaskWriteEntityBatch(std::vector<DBTaskWriteEntity*>& tasks);
+
+	virtual ~DBTaskWriteEntityBatch();
+	virtual bool db_thread_process();
+	virtual DBTaskBase* tryGetNextTask();
+	virtual thread::TPTask::TPTaskState presentMainThread();
+
+	virtual void pdbi(DBInterface* ptr);
+protected:
+	std::vector<DBTaskWriteEntity*> tasks_;
 };
 
 /**
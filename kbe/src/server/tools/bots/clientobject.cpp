@@ -21,6 +21,7 @@ along with KBEngine.  If not, see <http://www.gnu.org/licenses/>.
 #include "clientobject.hpp"
 #include "network/common.hpp"
 #include "network/message_handler.hpp"
+#include "network/reliable_udp_filter.hpp"
 #include "network/tcp_packet.hpp"
 #include "network/bundle.hpp"
 #include "network/fixed_messages.hpp"
@@ -58,7 +59,7 @@ ClientObjectBase(ninterface, getScriptType()),
 Mercury::TCPPacketReceiver(),
 error_(C_ERROR_NONE),
 state_(C_STATE_INIT),
-pBlowfishFilter_(0)
+pEncryptionFilter_(0)
 {
 	name_ = name;
 	typeClient_ = CLIENT_TYPE_BOTS;
@@ -70,7 +71,7 @@ pBlowfishFilter_(0)
 //-------------------------------------------------------------------------------------
 ClientObject::~ClientObject()
 {
-	SAFE_RELEASE(pBlowfishFilter_);
+	SAFE_RELEASE(pEncryptionFilter_);
 }
 
 //-------------------------------------------------------------------------------------		
@@ -122,6 +123,7 @@ bool ClientObject::initCreate()
 	pEndpoint->addr(addr);
 
 	pServerChannel_->endpoint(pEndpoint);
+	Mercury::installReliableUDPFilter(pServerChannel_);
 	pEndpoint->setnonblocking(true);
 	pEndpoint->setnodelay(true);
 
@@ -132,10 +134,10 @@ bool ClientObject::initCreate()
 	(*pBundle).newMessage(LoginappInterface::hello);
 	(*pBundle) << KBEVersion::versionString() << KBEVersion::scriptVersionString();
 
-	if(Mercury::g_channelExternalEncryptType == 1)
+	pEncryptionFilter_ = Mercury::createEncryptionFilter(Mercury::g_channelExternalEncryptType);
+	if(pEncryptionFilter_)
 	{
-		pBlowfishFilter_ = new Mercury::BlowfishFilter();
-		(*pBundle).appendBlob(pBlowfishFilter_->key());
+		(*pBundle).appendBlob(pEncryptionFilter_->key());
 	}
 	else
 	{
@@ -227,6 +229,7 @@ bool ClientObject::initLoginGateWay()
 	pEndpoint->addr(addr);
 
 	pServerChannel_->endpoint(pEndpoint);
+	Mercury::installReliableUDPFilter(pServerChannel_);
 	pEndpoint->setnonblocking(true);
 	pEndpoint->setnodelay(true);
 
@@ -237,10 +240,10 @@ bool ClientObject::initLoginGateWay()
 	(*pBundle).newMessage(BaseappInterface::hello);
 	(*pBundle) << KBEVersion::versionString() << KBEVersion::scriptVersionString();
 	
-	if(Mercury::g_channelExternalEncryptType == 1)
+	pEncryptionFilter_ = Mercury::createEncryptionFilter(Mercury::g_channelExternalEncryptType);
+	if(pEncryptionFilter_)
 	{
-		pBlowfishFilter_ = new Mercury::BlowfishFilter();
-		(*pBundle).appendBlob(pBlowfishFilter_->key());
+		(*pBundle).appendBlob(pEncryptionFilter_->key());
 		pServerChannel_->pFilter(NULL);
 	}
 	else
@@ -334,10 +337,10 @@ void ClientObject::gameTick()
 void ClientObject::onHelloCB_(Mercury::Channel* pChannel, const std::string& verInfo, 
 		const std::string& scriptVerInfo, COMPONENT_TYPE componentType)
 {
-	if(Mercury::g_channelExternalEncryptType == 1)
+	if(pEncryptionFilter_)
 	{
-		pChannel->pFilter(pBlowfishFilter_);
-		pBlowfishFilter_ = NULL;
+		pChannel->pFilter(pEncryptionFilter_);
+		pEncryptionFilter_ = NULL;
 	}
 
 	if(componentType == LOGINAPP_TYPE)
@@ -104,7 +104,7 @@ public:
 protected:
 	C_ERROR error_;
 	C_STATE state_;
-	Mercury::BlowfishFilter* pBlowfishFilter_;
+	Mercury::EncryptionFilter* pEncryptionFilter_;
 };
 
 